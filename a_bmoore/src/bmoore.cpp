@@ -11,6 +11,7 @@
 #include <vector>
 
 #include "bmoore.h"
+#include "cs225/profiler.h"
 
 /**
  * Takes in two strings (P and the alphabet) 
@@ -79,10 +80,12 @@ int findChar(std::string alpha, char c){
  * @param T A std::string object which holds the Text string.
  * @param alpha A std::string object which holds the Alphabet string.
  * @param outList An std::vector<int> array (by reference) that can be modified to contain all matches
+ * @param profiler An optional cs225::Profiler that records comparisons per text position and the shift from each alignment.
  *
  * @return An int counting the number of skipped alignments using bad character.
  */
-int bmoore_search(std::string P, std::string T, std::string alpha, std::vector<int> & outList) {
+int bmoore_search(std::string P, std::string T, std::string alpha, std::vector<int> & outList,
+                  cs225::Profiler* profiler) {
   // Preprocessing
   std::vector<std::vector<int>> bc_array = prep_bc_array(P, alpha);
 
@@ -106,6 +109,9 @@ int bmoore_search(std::string P, std::string T, std::string alpha, std::vector<i
     // Compare Alignment
     num_skips = 0;
     for (int pos{P_length - 1 + index}; pos >= index; pos--) {
+      if (profiler)
+        profiler->recordComparison(pos);
+
       // Move to Next Alignment
       if (P.at(pos - index) == T.at(pos)) {
         // Found Matching Pattern
@@ -134,7 +140,9 @@ int bmoore_search(std::string P, std::string T, std::string alpha, std::vector<i
       }
     }
 
-    // Set Skips
+    // Set Skips (the loop moves one more alignment)
+    if (profiler)
+      profiler->recordSkip(index, num_skips + 1);
     skip += num_skips;
     index += num_skips;
   }
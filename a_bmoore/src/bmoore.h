@@ -9,5 +9,10 @@
 #include <vector>
 #include <map>
 
+namespace cs225 {
+  class Profiler;
+}
+
 std::vector<std::vector<int>> prep_bc_array(std::string P, std::string alphabet);
-int bmoore_search(std::string P, std::string T, std::string alpha, std::vector<int> & outList);
\ No newline at end of file
+int bmoore_search(std::string P, std::string T, std::string alpha, std::vector<int> & outList,
+                  cs225::Profiler* profiler = nullptr);
\ No newline at end of file
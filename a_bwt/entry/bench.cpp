@@ -0,0 +1,99 @@
+/**
+ * @file bench.cpp
+ * Times BWT construction and inversion on a generated text and reports throughput and peak memory,
+ * then parallel inversion at several restart intervals and thread counts, and the memory
+ * and latency of random substring reads from a BWTStore at several sample rates.
+ *
+ * Usage: ./bench [TEXT_SIZE_IN_MB]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+
+#include <sys/resource.h>
+
+#include "bwt.h"
+#include "bwt_store.h"
+
+// Returns the peak resident set size of this process in MB
+double peak_mb() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss / 1024.0;
+}
+
+int main(int argc, char** argv) {
+  long mb = argc > 1 ? std::atol(argv[1]) : 64;
+  long n = mb << 20;
+
+  // DNA-like text with some long repeats, which stress suffix sorting
+  std::mt19937 rng(225);
+  std::string T;
+  T.reserve(n);
+  while (static_cast<long>(T.length()) < n) {
+    if (T.length() > 1000 && rng() % 64 == 0)
+      T += T.substr(rng() % (T.length() - 1000), 1000);
+    else
+      T += "ACGT"[rng() % 4];
+  }
+  T.resize(n);
+
+  double before = peak_mb();
+  auto start = std::chrono::steady_clock::now();
+  std::string bwt = encode_bwt(T);
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  std::cout << "encode_bwt: " << mb << " MB in " << seconds << " s ("
+            << mb / seconds << " MB/s), peak RSS " << peak_mb() << " MB ("
+            << (peak_mb() - before) / mb << " bytes/char above the input)" << std::endl;
+
+  start = std::chrono::steady_clock::now();
+  std::string decoded = decode_bwt(bwt);
+  seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  std::cout << "decode_bwt: " << mb << " MB in " << seconds << " s ("
+            << mb / seconds << " MB/s), " << (decoded == T ? "round trip ok" : "ROUND TRIP FAILED") << std::endl;
+
+  // Parallel inversion; coarser restart intervals are subsets of the finest one
+  size_t dollar;
+  RestartPoints fine;
+  encode_bwt(T, dollar, fine, 1024);
+  std::cout << "interval  index KB  threads  decode MB/s" << std::endl;
+  for (unsigned long factor : {1UL, 64UL, 4096UL}) {
+    RestartPoints restarts;
+    restarts.interval = fine.interval * factor;
+    for (size_t k{0}; k < fine.rows.size(); k += factor)
+      restarts.rows.push_back(fine.rows[k]);
+
+    for (unsigned threads : {1u, std::max(1u, std::thread::hardware_concurrency())}) {
+      start = std::chrono::steady_clock::now();
+      bool ok = decode_bwt_parallel(bwt, dollar, restarts, threads) == T;
+      seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      std::cout << restarts.interval << "\t  " << restarts.rows.size() * sizeof(size_t) / 1024.0 << "\t    "
+                << threads << "\t     " << mb / seconds << (ok ? "" : "  ROUND TRIP FAILED") << std::endl;
+    }
+  }
+
+  // Random reads of 64 characters from the BWT at several sample rates
+  std::cout << "rate   store MB   bytes/char   us per 64-char extract" << std::endl;
+  for (unsigned long rate : {4UL, 16UL, 64UL, 256UL}) {
+    BWTStore store(bwt, dollar, rate);
+    const int reads = 20000;
+    bool ok = true;
+    start = std::chrono::steady_clock::now();
+    for (int r{0}; r < reads; ++r) {
+      size_t i = rng() % (n - 64);
+      ok = ok && store.extract(i, 64) == T.substr(i, 64);
+    }
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << rate << "\t" << store.bytes() / 1048576.0 << "\t" << static_cast<double>(store.bytes()) / n
+              << "\t" << seconds / reads * 1e6 << (ok ? "" : "  EXTRACT FAILED") << std::endl;
+  }
+
+  return 0;
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+/**
+ * @file bwz.cpp
+ * Command line front end for the BWT block compressor.
+ *
+ * Usage: ./bwz c|d INPUT OUTPUT [-b BLOCK_KB] [-t THREADS]
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "bwz.h"
+
+int usage() {
+  std::cerr << "Usage: ./bwz c|d INPUT OUTPUT [-b BLOCK_KB] [-t THREADS]" << std::endl
+            << "  c  compress INPUT into OUTPUT" << std::endl
+            << "  d  decompress INPUT into OUTPUT" << std::endl
+            << "  -b block size in KB (default " << (BWZ_BLOCK_SIZE >> 10) << ")" << std::endl
+            << "  -t worker threads (default: all hardware threads)" << std::endl;
+  return 2;
+}
+
+int main(int argc, char** argv) {
+  if (argc < 4 || (std::strcmp(argv[1], "c") != 0 && std::strcmp(argv[1], "d") != 0))
+    return usage();
+
+  unsigned long blockSize = BWZ_BLOCK_SIZE;
+  unsigned threads = 0;
+  for (int i{4}; i < argc; ++i) {
+    if (std::strcmp(argv[i], "-b") == 0 && i + 1 < argc)
+      blockSize = std::strtoul(argv[++i], nullptr, 10) << 10;
+    else if (std::strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+      threads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+    else
+      return usage();
+  }
+
+  std::ifstream in(argv[2], std::ios::binary);
+  if (!in) {
+    std::cerr << "bwz: cannot read " << argv[2] << std::endl;
+    return 1;
+  }
+  std::ostringstream buffer;
+  buffer << in.rdbuf();
+  std::string input = buffer.str();
+
+  std::string output;
+  if (argv[1][0] == 'c') {
+    output = bwz_compress(input, blockSize, threads);
+  } else if (!bwz_decompress(input, output, threads)) {
+    std::cerr << "bwz: " << argv[2] << " is not a valid archive" << std::endl;
+    return 1;
+  }
+
+  std::ofstream out(argv[3], std::ios::binary);
+  out.write(output.data(), output.length());
+  if (!out) {
+    std::cerr << "bwz: cannot write " << argv[3] << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
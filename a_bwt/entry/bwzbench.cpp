@@ -0,0 +1,141 @@
+/**
+ * @file bwzbench.cpp
+ * Compares the BWT block compressor with zlib (gzip levels 1, 6 and 9) on ratio and throughput.
+ * zlib rows are only printed when the build found zlib.
+ *
+ * Usage: ./bwzbench [TEXT_SIZE_IN_MB] [THREADS] [FILE...]
+ * Without files, three generated corpora are measured: English-like text, DNA and binary records.
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#include "bwz.h"
+
+typedef std::chrono::steady_clock Clock;
+
+double since(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Words with a skewed (roughly Zipfian) distribution and occasional punctuation
+std::string make_english(long n, std::mt19937& rng) {
+  static const std::vector<std::string> words = {"the", "of", "and", "to", "in", "a", "is",
+    "that", "for", "it", "as", "was", "with", "be", "by", "on", "not", "he", "this", "are",
+    "or", "his", "from", "at", "which", "but", "have", "an", "had", "they", "you", "were",
+    "compression", "transform", "block", "suffix", "array", "sorting", "entropy", "Burrows"};
+
+  std::string T;
+  T.reserve(n + 16);
+  while (static_cast<long>(T.length()) < n) {
+    double u = std::generate_canonical<double, 32>(rng);
+    T += words[static_cast<size_t>(words.size() * u * u)];
+    T += rng() % 12 == 0 ? ".\n" : " ";
+  }
+  T.resize(n);
+  return T;
+}
+
+// DNA with long approximate repeats
+std::string make_dna(long n, std::mt19937& rng) {
+  std::string T;
+  T.reserve(n + 1000);
+  while (static_cast<long>(T.length()) < n) {
+    if (T.length() > 1000 && rng() % 64 == 0)
+      T += T.substr(rng() % (T.length() - 1000), 1000);
+    else
+      T += "ACGT"[rng() % 4];
+  }
+  T.resize(n);
+  return T;
+}
+
+// Fixed-size binary records: a counter, a small enum and a noisy measurement
+std::string make_records(long n, std::mt19937& rng) {
+  std::string T;
+  T.reserve(n + 16);
+  for (uint32_t id{0}; static_cast<long>(T.length()) < n; ++id) {
+    uint32_t fields[4] = {id, static_cast<uint32_t>(rng() % 5), 1000 + static_cast<uint32_t>(rng() % 64), 0};
+    T.append(reinterpret_cast<const char*>(fields), sizeof(fields));
+  }
+  T.resize(n);
+  return T;
+}
+
+void report(const std::string& corpus, const std::string& codec, size_t in, size_t out,
+            double compressSeconds, double decompressSeconds, bool ok) {
+  double mb = in / 1048576.0;
+  std::cout << std::left << std::setw(10) << corpus << std::setw(10) << codec
+            << std::right << std::fixed << std::setprecision(3)
+            << std::setw(8) << static_cast<double>(in) / out
+            << std::setw(12) << mb / compressSeconds
+            << std::setw(12) << mb / decompressSeconds
+            << (ok ? "" : "  ROUND TRIP FAILED") << std::endl;
+}
+
+void measure(const std::string& corpus, const std::string& data, unsigned threads) {
+  auto start = Clock::now();
+  std::string archive = bwz_compress(data, BWZ_BLOCK_SIZE, threads);
+  double c = since(start);
+
+  std::string restored;
+  start = Clock::now();
+  bool ok = bwz_decompress(archive, restored, threads) && restored == data;
+  double d = since(start);
+  report(corpus, "bwz", data.length(), archive.length(), c, d, ok);
+
+#ifdef HAVE_ZLIB
+  for (int level : {1, 6, 9}) {
+    uLongf size = compressBound(data.length());
+    std::string packed(size, '\0');
+    start = Clock::now();
+    compress2(reinterpret_cast<Bytef*>(&packed[0]), &size,
+              reinterpret_cast<const Bytef*>(data.data()), data.length(), level);
+    c = since(start);
+
+    std::string unpacked(data.length(), '\0');
+    uLongf unpackedSize = unpacked.length();
+    start = Clock::now();
+    bool zok = uncompress(reinterpret_cast<Bytef*>(&unpacked[0]), &unpackedSize,
+                          reinterpret_cast<const Bytef*>(packed.data()), size) == Z_OK && unpacked == data;
+    d = since(start);
+    report(corpus, "zlib-" + std::to_string(level), data.length(), size, c, d, zok);
+  }
+#endif
+}
+
+int main(int argc, char** argv) {
+  long mb = argc > 1 ? std::atol(argv[1]) : 8;
+  unsigned threads = argc > 2 ? static_cast<unsigned>(std::atoi(argv[2])) : 0;
+
+  std::cout << "corpus    codec        ratio  comp MB/s  decomp MB/s" << std::endl;
+
+  if (argc > 3) {
+    for (int i{3}; i < argc; ++i) {
+      std::ifstream in(argv[i], std::ios::binary);
+      std::ostringstream buffer;
+      buffer << in.rdbuf();
+      measure(argv[i], buffer.str(), threads);
+    }
+    return 0;
+  }
+
+  std::mt19937 rng(225);
+  long n = mb << 20;
+  measure("english", make_english(n, rng), threads);
+  measure("dna", make_dna(n, rng), threads);
+  measure("records", make_records(n, rng), threads);
+
+  return 0;
+}
@@ -0,0 +1,51 @@
+/**
+ * @file collection.cpp
+ * Builds the BWT of a file of reads (one per line) and reports time and peak memory per symbol.
+ * The read of every '$' row is written to OUTPUT.ids, one per line.
+ *
+ * Usage: ./collection READS OUTPUT
+ */
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+#include <sys/resource.h>
+
+#include "bwt_collection.h"
+
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    std::cerr << "Usage: ./collection READS OUTPUT" << std::endl;
+    return 2;
+  }
+  std::string output = argv[2];
+
+  auto start = std::chrono::steady_clock::now();
+  std::vector<size_t> ids;
+  long reads = encode_bwt_collection(argv[1], output, ids);
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  if (reads < 0) {
+    std::cerr << "collection: could not read " << argv[1] << " (or a read holds '$') or write " << output << std::endl;
+    return 1;
+  }
+
+  std::ofstream idFile(output + ".ids");
+  for (size_t id : ids)
+    idFile << id << '\n';
+  if (!idFile) {
+    std::cerr << "collection: could not write " << output << ".ids" << std::endl;
+    return 1;
+  }
+
+  std::ifstream bwt(output, std::ios::binary | std::ios::ate);
+  long symbols = static_cast<long>(bwt.tellg()) - reads;
+
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  std::cout << reads << " reads, " << symbols << " symbols, " << seconds << " s, peak RSS "
+            << usage.ru_maxrss / 1024.0 << " MB ("
+            << (symbols > 0 ? usage.ru_maxrss * 1024.0 / symbols : 0) << " bytes/symbol)" << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,56 @@
+/**
+ * @file dynamic.cpp
+ * Grows a DynamicBWT by daily appends and compares each append with rebuilding
+ * the BWT of the whole text with encode_bwt.
+ *
+ * Usage: ./dynamic [BASE_SIZE_IN_MB] [APPEND_SIZE_IN_KB]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "bwt.h"
+#include "dynamic_bwt.h"
+
+int main(int argc, char** argv) {
+  long base = (argc > 1 ? std::atol(argv[1]) : 8) << 20;
+  long chunk = (argc > 2 ? std::atol(argv[2]) : 256) << 10;
+
+  std::mt19937 rng(39);
+  auto generate = [&rng](long n) {
+    std::string s;
+    for (long i{0}; i < n; ++i)
+      s += "ACGT"[rng() % 4];
+    return s;
+  };
+
+  std::string T = generate(base);
+  auto start = std::chrono::steady_clock::now();
+  DynamicBWT dyn(T);
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  std::cout << "initial " << (base >> 20) << " MB: " << seconds << " s (" << (base >> 20) / seconds
+            << " MB/s), " << static_cast<double>(dyn.bytes()) / base << " bytes/char" << std::endl;
+
+  std::cout << "day  text MB  append s  rebuild s  count ok" << std::endl;
+  for (int day{1}; day <= 4; ++day) {
+    std::string next = generate(chunk);
+    start = std::chrono::steady_clock::now();
+    dyn.append(next);
+    double append = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    T += next;
+
+    start = std::chrono::steady_clock::now();
+    std::string rebuilt = encode_bwt(T);
+    double rebuild = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // A pattern that straddles the new chunk occurs at least once
+    std::string P = T.substr(T.length() - chunk - 8, 16);
+    std::cout << day << "\t" << T.length() / 1048576.0 << "\t" << append << "\t" << rebuild << "\t"
+              << (dyn.count(P) > 0 && dyn.length() == T.length() ? "yes" : "NO") << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,38 @@
+/**
+ * @file external.cpp
+ * Builds the BWT of a file in bounded memory and reports time and peak memory.
+ *
+ * Usage: ./external INPUT OUTPUT [MEMORY_MB]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+#include <sys/resource.h>
+
+#include "bwt_external.h"
+
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    std::cerr << "Usage: ./external INPUT OUTPUT [MEMORY_MB]" << std::endl;
+    return 2;
+  }
+  unsigned long memory = argc > 3 ? std::strtoul(argv[3], nullptr, 10) << 20 : EXTERNAL_BWT_MEMORY;
+
+  auto start = std::chrono::steady_clock::now();
+  long dollar = encode_bwt_external(argv[1], argv[2], memory);
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  if (dollar < 0) {
+    std::cerr << "external: could not read " << argv[1] << " or write " << argv[2] << std::endl;
+    return 1;
+  }
+
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  std::cout << "sentinel row " << dollar << ", " << seconds << " s, block "
+            << external_bwt_block(memory) << " bytes, peak RSS " << usage.ru_maxrss / 1024.0
+            << " MB (limit " << (memory >> 20) << " MB)" << std::endl;
+
+  return 0;
+}
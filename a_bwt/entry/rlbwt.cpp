@@ -0,0 +1,67 @@
+/**
+ * @file rlbwt.cpp
+ * Reports the number of BWT runs r against the text length n for a file, or for generated
+ * collections of near-identical copies at several mutation rates, together with the size
+ * of the run-length BWT and the speed of inverting it in compressed space.
+ *
+ * Usage: ./rlbwt [FILE]
+ */
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+
+#include "bwt.h"
+#include "rlbwt.h"
+
+// Prints one report line for T
+void report(const std::string& name, const std::string& T) {
+  size_t dollar;
+  std::string bwt = encode_bwt(T, dollar);
+  RLBWT rl(bwt, dollar);
+
+  auto start = std::chrono::steady_clock::now();
+  bool ok = rl.decode() == T;
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  std::cout << name << "\t" << rl.length() << "\t" << rl.runs() << "\t" << rl.runRatio() << "\t"
+            << rl.bytes() / 1024.0 << "\t" << bwt.length() / 1024.0 << "\t"
+            << rl.length() / seconds / (1 << 20) << (ok ? "" : "  ROUND TRIP FAILED") << std::endl;
+}
+
+int main(int argc, char** argv) {
+  std::cout << "input\tn\tr\tr/n\tRLBWT KB\tBWT KB\tdecode MB/s" << std::endl;
+
+  if (argc > 1) {
+    std::ifstream in(argv[1], std::ios::binary);
+    if (!in) {
+      std::cerr << "cannot read " << argv[1] << std::endl;
+      return 1;
+    }
+    report(argv[1], std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()));
+    return 0;
+  }
+
+  // 64 copies of a 256 KB DNA-like genome, each with its own point mutations
+  std::mt19937 rng(37);
+  std::string genome;
+  for (size_t i{0}; i < (1 << 18); ++i)
+    genome += "ACGT"[rng() % 4];
+
+  for (double rate : {0.0, 0.0001, 0.001, 0.01, 0.1}) {
+    std::string T;
+    for (size_t k{0}; k < 64; ++k) {
+      std::string copy = genome;
+      for (size_t i{0}; i < copy.length(); ++i)
+        if (rng() < rate * rng.max())
+          copy[i] = "ACGT"[rng() % 4];
+      T += copy;
+    }
+    report("mut " + std::to_string(rate), T);
+  }
+
+  return 0;
+}
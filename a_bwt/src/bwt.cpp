@@ -8,8 +8,19 @@
 #include <cstdlib>
 #include <map>
 #include <algorithm>
+#include <cstdint>
+#include <array>
+#include <thread>
 
 #include "bwt.h"
+#include "parallel.h"
+#include "sais.h"
+
+// Segments decoded in lockstep by one thread of decode_bwt_parallel
+static const size_t DECODE_LANES = 8;
+
+// Smallest BWT chunk worth a thread when building the LF-mapping
+static const size_t LF_MIN_CHUNK = 1 << 16;
 
 /**
  * Returns a vector of strings containing all rotations of a text
@@ -34,60 +45,265 @@ std::vector<std::string> rotate(std::string T){
 }
 
 
+/**
+ * Writes the BWT of T + '$' into a string by building the suffix array with SA-IS.
+ * The BWT is written over the suffix array's own storage as it is read,
+ * so peak memory is about |T| + (sizeof(Index) + 1) * (|T| + 1) bytes.
+ * The row whose last character is the sentinel is stored in dollar, and if restarts
+ * is given, the row of every restarts->interval-th suffix is recorded in it.
+ */
+template <typename Index>
+static std::string encode_bwt_sais(const std::string& T, size_t& dollar, RestartPoints* restarts) {
+  Index n = static_cast<Index>(T.length()) + 1;
+  SentinelText<Index> text{reinterpret_cast<const unsigned char*>(T.data()), n - 1};
+
+  Index* SA = new Index[n];
+  sais<Index>(text, SA, n, 256);
+
+  // Byte i of SA's storage lies in SA[i / sizeof(Index)], which has already been read
+  char* bwt = reinterpret_cast<char*>(SA);
+  for (Index i{0}; i < n; ++i) {
+    Index pos = SA[i];
+    if (pos == 0)
+      dollar = i;
+    if (restarts && pos < n - 1 && pos % restarts->interval == 0)
+      restarts->rows[pos / restarts->interval] = i;
+    bwt[i] = pos == 0 ? '$' : T[pos - 1];
+  }
+
+  std::string BWT(bwt, n);
+  delete[] SA;
+
+  return BWT;
+}
+
 /**
  * Returns the BWT of T as a string
+ * The appended '$' is treated as a unique character smaller than every other,
+ * and the suffix array is built in linear time with SA-IS.
  *
  * @param T A std::string object which holds the text being pre-processed.
  *
  * @return An std::string storing the BWT
  */
-std::string encode_bwt(std::string T){
-  // Create All Rotations
-  std::vector<std::string> BWT_matrix = rotate(T + '$');
-
-  // Sort the Rotations
-  std::sort(BWT_matrix.begin(), BWT_matrix.end());
-
-  // Return the Last Column of BWT Matrix
-  std::string BWT;
-  for (auto e: BWT_matrix)
-    BWT += e.back();
+std::string encode_bwt(const std::string& T){
+  size_t dollar;
+  return encode_bwt(T, dollar);
+}
 
-  return BWT;
+/**
+ * Returns the BWT of T as a string and stores the row of the sentinel in dollar.
+ * T may itself contain '$'; only the byte at position dollar is the sentinel.
+ *
+ * @param T A std::string object which holds the text being pre-processed.
+ * @param dollar Receives the index of the sentinel in the returned BWT
+ *
+ * @return An std::string storing the BWT
+ */
+std::string encode_bwt(const std::string& T, size_t& dollar){
+  // 32-bit suffix array entries whenever they suffice
+  if (T.length() < 0x7fffffffUL)
+    return encode_bwt_sais<int32_t>(T, dollar, nullptr);
+  return encode_bwt_sais<int64_t>(T, dollar, nullptr);
 }
 
 /**
- * Returns the BWT of T as a string
+ * Returns the BWT of T and records restart points for decode_bwt_parallel:
+ * the BWT row of every interval-th suffix of T. A smaller interval costs
+ * 8 bytes per restart point and gives more segments to decode in parallel.
  *
  * @param T A std::string object which holds the text being pre-processed.
+ * @param dollar Receives the index of the sentinel in the returned BWT
+ * @param restarts Receives the restart points
+ * @param interval The distance between restart points in T (at least 1)
  *
  * @return An std::string storing the BWT
  */
+std::string encode_bwt(const std::string& T, size_t& dollar, RestartPoints& restarts, unsigned long interval){
+  restarts.interval = std::max(interval, 1UL);
+  // Rounded up without T.length() + interval - 1, which overflows for huge intervals
+  restarts.rows.assign(T.length() / restarts.interval + (T.length() % restarts.interval != 0), 0);
 
-std::string decode_bwt(std::string bwt){
-  // Store BWT Matrix w/ Each String as a Row
-  std::vector<std::string> BWT_matrix;
+  if (T.length() < 0x7fffffffUL)
+    return encode_bwt_sais<int32_t>(T, dollar, &restarts);
+  return encode_bwt_sais<int64_t>(T, dollar, &restarts);
+}
 
-  // Initialize Matrix
-  for (unsigned long i{0}; i < bwt.length(); ++i) {
-    BWT_matrix.push_back("");
-  }
+/**
+ * Builds the LF-mapping of a BWT. Each entry packs LF(i) above the 8-bit character
+ * bwt[i], so every step of a walk costs one random memory access instead of two.
+ * The BWT is cut into one chunk per thread: chunks count their characters, and
+ * prefix sums over (character, chunk) give every chunk its own starting ranks.
+ */
+template <typename Packed>
+static std::vector<Packed> build_lf(const std::string& bwt, size_t dollar, unsigned threads) {
+  size_t n = bwt.length();
+  if (threads == 0)
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  size_t chunks = std::max<size_t>(1, std::min<size_t>(threads, n / LF_MIN_CHUNK));
+
+  // next[t][c]: characters c in chunks before t, counted per chunk first
+  std::vector<std::array<size_t, 256>> next(chunks);
+  parallel_for(chunks, threads, [&](size_t t) {
+    next[t].fill(0);
+    for (size_t i{n * t / chunks}; i < n * (t + 1) / chunks; ++i) {
+      if (i != dollar)
+        next[t][static_cast<unsigned char>(bwt[i])]++;
+    }
+  });
 
-  // Reconstruct BWT Matrix
-  for (unsigned long i{0}; i < bwt.length(); ++i) {
-    // Prepend Each Character of BWT to each Row
-    for (unsigned long j{0}; j < bwt.length(); ++j) {
-      BWT_matrix.at(j).insert(0, 1, bwt.at(j));
+  // Rows starting with c follow '$' (row 0) and every smaller character
+  size_t sum = 1;
+  for (int c{0}; c < 256; ++c) {
+    for (size_t t{0}; t < chunks; ++t) {
+      size_t count = next[t][c];
+      next[t][c] = sum;
+      sum += count;
     }
-    // Sort Each Row During Prepend
-    sort(BWT_matrix.begin(), BWT_matrix.end());
   }
 
-  // Return Row Ending with $
-  for (auto e: BWT_matrix) {
-    if (e.back() == '$')
-      return e.substr(0, e.length() - 1);
+  // LF(i) = C[c] + (occurrences of c before i)
+  std::vector<Packed> LF(n);
+  parallel_for(chunks, threads, [&](size_t t) {
+    for (size_t i{n * t / chunks}; i < n * (t + 1) / chunks; ++i) {
+      if (i == dollar)
+        continue;
+      unsigned char c = bwt[i];
+      LF[i] = (static_cast<Packed>(next[t][c]++) << 8) | c;
+    }
+  });
+
+  return LF;
+}
+
+/**
+ * Inverts a BWT by walking the LF-mapping from the row starting with '$'.
+ */
+template <typename Packed>
+static std::string decode_bwt_lf(const std::string& bwt, size_t dollar) {
+  size_t n = bwt.length();
+  std::vector<Packed> LF = build_lf<Packed>(bwt, dollar, 1);
+
+  // Row 0 is '$' + T, so its last character is the end of T
+  std::string T(n - 1, '\0');
+  Packed entry = LF[0];
+  for (size_t k{n - 1}; k-- > 0;) {
+    T[k] = static_cast<char>(entry & 0xff);
+    entry = LF[entry >> 8];
   }
 
-  return "";
+  return T;
+}
+
+/**
+ * Inverts a BWT one segment per restart point: segment s is T[s * interval, (s + 1) * interval)
+ * and is walked backwards from the row of the suffix that follows it.
+ * Each thread walks DECODE_LANES segments in lockstep, so their cache misses overlap.
+ */
+template <typename Packed>
+static std::string decode_bwt_segments(const std::string& bwt, size_t dollar, const RestartPoints& restarts,
+                                       unsigned threads) {
+  size_t n = bwt.length() - 1;
+  size_t interval = restarts.interval;
+  size_t segments = restarts.rows.size();
+  std::vector<Packed> LF = build_lf<Packed>(bwt, dollar, threads);
+
+  std::string T(n, '\0');
+  size_t groups = (segments + DECODE_LANES - 1) / DECODE_LANES;
+  parallel_for(groups, threads, [&](size_t g) {
+    Packed entry[DECODE_LANES];
+    size_t pos[DECODE_LANES];
+    size_t begin[DECODE_LANES];
+    for (size_t lane{0}; lane < DECODE_LANES; ++lane) {
+      size_t s = g * DECODE_LANES + lane;
+      if (s >= segments) {
+        pos[lane] = begin[lane] = 0;
+        entry[lane] = 0;
+        continue;
+      }
+      begin[lane] = s * interval;
+      pos[lane] = interval < n - begin[lane] ? begin[lane] + interval : n;
+      // Row 0 is the suffix at n
+      entry[lane] = LF[s + 1 < segments ? restarts.rows[s + 1] : 0];
+    }
+
+    for (size_t step{0}; step < std::min(interval, n); ++step) {
+      for (size_t lane{0}; lane < DECODE_LANES; ++lane) {
+        if (pos[lane] == begin[lane])
+          continue;
+        T[--pos[lane]] = static_cast<char>(entry[lane] & 0xff);
+        entry[lane] = LF[entry[lane] >> 8];
+      }
+    }
+  });
+
+  return T;
+}
+
+/**
+ * Returns the original text of a BWT as a string
+ * The BWT may hold any byte, but must hold exactly one '$' (the sentinel).
+ * Runs in linear time with the LF-mapping; returns "" for an invalid BWT.
+ *
+ * @param bwt A std::string object which holds the BWT.
+ *
+ * @return An std::string storing the original text
+ */
+std::string decode_bwt(const std::string& bwt){
+  size_t dollar = bwt.find('$');
+  if (dollar == std::string::npos || bwt.find('$', dollar + 1) != std::string::npos)
+    return "";
+
+  return decode_bwt(bwt, dollar);
+}
+
+/**
+ * Returns the original text of a BWT whose sentinel is known to sit at index dollar.
+ * Every other byte, including '$', is an ordinary character; the byte at dollar is ignored.
+ * Returns "" if dollar is not a valid sentinel row.
+ *
+ * @param bwt A std::string object which holds the BWT.
+ * @param dollar The index of the sentinel in bwt
+ *
+ * @return An std::string storing the original text
+ */
+std::string decode_bwt(const std::string& bwt, size_t dollar){
+  // Row 0 ends with '$' only for the empty text
+  if (dollar == 0 || dollar >= bwt.length())
+    return "";
+
+  // 24 bits of LF fit beside the character in 32 bits; larger inputs use 64-bit entries
+  if (bwt.length() < (1UL << 24))
+    return decode_bwt_lf<uint32_t>(bwt, dollar);
+  return decode_bwt_lf<uint64_t>(bwt, dollar);
+}
+
+/**
+ * Returns the original text of a BWT, decoding the segments between restart points
+ * (recorded by encode_bwt) on several threads.
+ * Falls back to the sequential walk if the restart points do not fit the BWT.
+ *
+ * @param bwt A std::string object which holds the BWT.
+ * @param dollar The index of the sentinel in bwt
+ * @param restarts The restart points recorded when bwt was encoded
+ * @param threads The number of worker threads (0 uses every hardware thread)
+ *
+ * @return An std::string storing the original text
+ */
+std::string decode_bwt_parallel(const std::string& bwt, size_t dollar, const RestartPoints& restarts, unsigned threads){
+  if (dollar == 0 || dollar >= bwt.length())
+    return "";
+
+  size_t n = bwt.length() - 1;
+  size_t interval = restarts.interval;
+  // The suffix at 0 is all of T, whose row is the sentinel's
+  bool valid = interval > 0 && restarts.rows.size() == n / interval + (n % interval != 0) && restarts.rows[0] == dollar;
+  for (size_t k{0}; valid && k < restarts.rows.size(); ++k)
+    valid = restarts.rows[k] < bwt.length();
+  if (!valid)
+    return decode_bwt(bwt, dollar);
+
+  if (bwt.length() < (1UL << 24))
+    return decode_bwt_segments<uint32_t>(bwt, dollar, restarts, threads);
+  return decode_bwt_segments<uint64_t>(bwt, dollar, restarts, threads);
 }
@@ -13,5 +13,25 @@
 std::vector<std::string> rotate(std::string T);
 
 // Your assignment is to build these two functions
-std::string encode_bwt(std::string T);
-std::string decode_bwt(std::string T);
\ No newline at end of file
+std::string encode_bwt(const std::string& T);
+std::string decode_bwt(const std::string& bwt);
+
+// Variants for binary texts that may contain '$': the sentinel's row is passed explicitly
+std::string encode_bwt(const std::string& T, size_t& dollar);
+std::string decode_bwt(const std::string& bwt, size_t dollar);
+
+// Default distance between restart points for parallel decoding
+const unsigned long BWT_RESTART_INTERVAL = 1UL << 16;
+
+// rows[k] is the BWT row of the suffix starting at k * interval
+struct RestartPoints
+{
+  unsigned long interval = 0;
+  std::vector<size_t> rows;
+};
+
+// Parallel inversion: segments between restart points are decoded independently
+std::string encode_bwt(const std::string& T, size_t& dollar, RestartPoints& restarts,
+                       unsigned long interval = BWT_RESTART_INTERVAL);
+std::string decode_bwt_parallel(const std::string& bwt, size_t dollar, const RestartPoints& restarts,
+                                unsigned threads = 0);
\ No newline at end of file
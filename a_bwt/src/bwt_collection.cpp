@@ -0,0 +1,225 @@
+/**
+ * @file bwt_collection.cpp
+ * Code to build the BWT of a read collection by inserting one symbol column per step
+ * (after Bauer, Cox & Rosone, "Lightweight algorithms for constructing and inverting
+ * the BWT of string collections").
+ *
+ * After step j the piles hold the BWT of every suffix of length at most j (plus its
+ * sentinel), split by first character. Step j + 1 extends the suffix of length j of
+ * every read by the symbol before it. That symbol c is exactly the BWT character of
+ * the old suffix's row, so the new suffix's row in pile c is the number of c's in the
+ * rows before it: its rank. Reads are visited in row order, so the ranks come from a
+ * single scan of the piles, and the new suffixes of each pile arrive in order too.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+
+#include "bwt_collection.h"
+#include "chunk_io.h"
+
+namespace {
+
+// Pile 0 holds the bare sentinels, pile 1 + c the suffixes starting with byte c
+const int BCR_PILES = 257;
+
+// All reads back to back, without separators
+struct Reads
+{
+  std::string text;
+  std::vector<size_t> start{0};
+
+  size_t count() const {
+    return start.size() - 1;
+  }
+
+  size_t length(size_t i) const {
+    return start[i + 1] - start[i];
+  }
+
+  char at(size_t i, size_t k) const {
+    return text[start[i] + k];
+  }
+};
+
+bool load_reads(const std::string& path, Reads& reads) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in)
+    return false;
+  in.seekg(0, std::ios::end);
+  reads.text.reserve(static_cast<size_t>(in.tellg()));
+  in.seekg(0);
+
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.empty())
+      continue;
+    if (line.find('$') != std::string::npos)
+      return false;
+    reads.text += line;
+    reads.start.push_back(reads.text.length());
+  }
+
+  return true;
+}
+
+std::string pile_path(const std::string& outputPath, int pile) {
+  return outputPath + ".pile" + std::to_string(pile);
+}
+
+void remove_piles(const std::string& outputPath) {
+  for (int p{0}; p < BCR_PILES; ++p) {
+    std::remove(pile_path(outputPath, p).c_str());
+    std::remove((pile_path(outputPath, p) + ".new").c_str());
+  }
+}
+
+}
+
+/**
+ * Writes the BWT of the reads in readsPath to outputPath.
+ *
+ * @param readsPath The file of reads, one per line
+ * @param outputPath The file receiving the BWT
+ * @param ids Receives the read of every '$' row, in row order
+ *
+ * @return The number of reads, or -1 on error
+ */
+long encode_bwt_collection(const std::string& readsPath, const std::string& outputPath,
+                           std::vector<size_t>& ids) {
+  Reads reads;
+  if (!load_reads(readsPath, reads))
+    return -1;
+  size_t m = reads.count();
+  size_t maxLength = 0;
+  for (size_t i{0}; i < m; ++i)
+    maxLength = std::max(maxLength, reads.length(i));
+
+  std::vector<size_t> pileSize(BCR_PILES, 0);
+  // hist[p][c]: occurrences of c in pile p, so piles before a read's need not be scanned
+  std::vector<std::vector<size_t>> hist(BCR_PILES, std::vector<size_t>(256, 0));
+  // dollarIds[p]: the read of every '$' in pile p, in order
+  std::vector<std::vector<size_t>> dollarIds(BCR_PILES);
+
+  // Step 0: the bare sentinels sort by read, and each is preceded by its read's last symbol
+  std::vector<size_t> order(m);
+  std::vector<size_t> pos(m);
+  ChunkWriter first(pile_path(outputPath, 0));
+  for (size_t i{0}; i < m; ++i) {
+    char c = reads.at(i, reads.length(i) - 1);
+    first.put(c);
+    hist[0][static_cast<unsigned char>(c)]++;
+    order[i] = i;
+    pos[i] = i;
+  }
+  pileSize[0] = m;
+  bool ok = first.close();
+
+  for (size_t j{1}; ok && j <= maxLength; ++j) {
+    // Reads of length j - 1 inserted their sentinel last step and are finished
+    order.erase(std::remove_if(order.begin(), order.end(), [&](size_t i) { return reads.length(i) < j; }),
+                order.end());
+
+    // Rank every read's new symbol among the rows before its suffix, in row order
+    std::vector<size_t> before(256, 0);
+    std::vector<size_t> counts;
+    std::unique_ptr<ChunkReader> in;
+    int pile = 0;
+    int current = -1;
+    size_t scanned = 0;
+    for (size_t i : order) {
+      size_t len = reads.length(i);
+      int p = j == 1 ? 0 : 1 + static_cast<unsigned char>(reads.at(i, len - j + 1));
+      if (p != current) {
+        for (; pile < p; ++pile) {
+          for (int c{0}; c < 256; ++c)
+            before[c] += hist[pile][c];
+        }
+        counts = before;
+        in.reset(new ChunkReader(pile_path(outputPath, p)));
+        current = p;
+        scanned = 0;
+      }
+      for (char c; ok && scanned < pos[i]; ++scanned) {
+        ok = in->get(c);
+        counts[static_cast<unsigned char>(ok ? c : 0)]++;
+      }
+      pos[i] = counts[static_cast<unsigned char>(reads.at(i, len - j))];
+    }
+    in.reset();
+
+    // Regroup by new pile; ranks grow with row order, so each pile stays sorted
+    std::vector<size_t> bucket(BCR_PILES + 1, 0);
+    for (size_t i : order)
+      bucket[2 + static_cast<unsigned char>(reads.at(i, reads.length(i) - j))]++;
+    for (int q{1}; q <= BCR_PILES; ++q)
+      bucket[q] += bucket[q - 1];
+    std::vector<size_t> next(order.size());
+    for (size_t i : order)
+      next[bucket[1 + static_cast<unsigned char>(reads.at(i, reads.length(i) - j))]++] = i;
+    order.swap(next);
+
+    // Rewrite every pile that receives symbols, inserting them at their ranks
+    for (int q{1}; ok && q < BCR_PILES; ++q) {
+      size_t lo = bucket[q - 1];
+      size_t hi = bucket[q];
+      if (lo == hi)
+        continue;
+
+      std::string path = pile_path(outputPath, q);
+      std::vector<size_t> newIds;
+      {
+        ChunkReader old(path);
+        ChunkWriter out(path + ".new");
+        size_t written = 0;
+        size_t oldDollar = 0;
+        auto copy = [&](size_t until) {
+          for (char c; ok && written < until; ++written) {
+            if (!(ok = old.get(c)))
+              break;
+            if (c == '$')
+              newIds.push_back(dollarIds[q][oldDollar++]);
+            out.put(c);
+          }
+        };
+
+        for (size_t k{lo}; ok && k < hi; ++k) {
+          size_t i = order[k];
+          copy(pos[i]);
+          size_t len = reads.length(i);
+          char x = len > j ? reads.at(i, len - j - 1) : '$';
+          if (x == '$')
+            newIds.push_back(i);
+          out.put(x);
+          written++;
+          hist[q][static_cast<unsigned char>(x)]++;
+        }
+        copy(pileSize[q] + hi - lo);
+        ok = out.close() && ok;
+      }
+
+      pileSize[q] += hi - lo;
+      dollarIds[q].swap(newIds);
+      ok = ok && std::rename((path + ".new").c_str(), path.c_str()) == 0;
+    }
+  }
+
+  // The BWT is the piles in order
+  ChunkWriter out(outputPath);
+  ids.clear();
+  for (int p{0}; ok && p < BCR_PILES; ++p) {
+    ChunkReader in(pile_path(outputPath, p));
+    for (size_t k{0}; ok && k < pileSize[p]; ++k) {
+      char c;
+      if ((ok = in.get(c)))
+        out.put(c);
+    }
+    ids.insert(ids.end(), dollarIds[p].begin(), dollarIds[p].end());
+  }
+  ok = out.close() && ok;
+  remove_piles(outputPath);
+
+  return ok ? static_cast<long>(m) : -1;
+}
@@ -0,0 +1,33 @@
+/**
+ * @file bwt_collection.h
+ * Declarations of the BWT of a collection of strings, each with its own sentinel.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+/**
+ * Writes the BWT of a collection of reads (one per line of readsPath, empty lines skipped)
+ * to outputPath, building it column by column from the right (Bauer, Cox & Rosone, BCR).
+ *
+ * Read i ends with its own sentinel $_i, and $_i < $_j for i < j, all below every byte.
+ * The output has one row per suffix of every read, including the bare sentinels, so it
+ * holds (total read length) + (number of reads) bytes; a '$' marks the row whose suffix
+ * is a whole read, and ids[k] names the read of the k-th such row in row order.
+ *
+ * Step j inserts the j-th last symbol of every read into partial BWTs kept as one file
+ * per first character (a pile). Each step reads the piles once to rank the new suffixes
+ * and rewrites only the piles that receive symbols, both strictly sequentially. Memory
+ * is one byte per symbol for the reads plus four words per read, with no suffix array.
+ * Temporary piles live next to outputPath and are removed afterwards.
+ *
+ * @param readsPath The file of reads (which must not contain '$')
+ * @param outputPath The file receiving the BWT
+ * @param ids Receives the read of every '$' row, in row order
+ *
+ * @return The number of reads, or -1 if a file could not be read or written or a read holds '$'
+ */
+long encode_bwt_collection(const std::string& readsPath, const std::string& outputPath,
+                           std::vector<size_t>& ids);
@@ -0,0 +1,346 @@
+/**
+ * @file bwt_external.cpp
+ * Code to build the BWT of a file in bounded memory by merging blocks from right to left
+ * (after Ferragina, Gagie & Manzini, "Lightweight data indexing and compression in external memory").
+ *
+ * Let B = T[a, b) be the current block and S = T[b, n) the suffix already processed,
+ * whose BWT is on disk. One phase turns it into the BWT of T[a, n):
+ *
+ *   1. For every k in B decide whether T[k..] > S. Matching B against the first block
+ *      of S gives the answer unless T[k, b) is a prefix of S; then it is decided by
+ *      whether S[b - k..] > S, which the previous phase kept as a bit vector.
+ *   2. Sort the suffixes of B (and S itself) with SA-IS. Folding the bit of step 1 into
+ *      every symbol makes comparisons that run off the end of B come out right.
+ *   3. Scan S backwards, locating every suffix of S among the sorted block suffixes with
+ *      LF steps over the block, and count how many fall between each pair (the gap array).
+ *      An LF step needs to know whether the suffix is greater than S; a bit file on disk
+ *      holds that for every suffix of S and is rewritten relative to T[a..] during the scan.
+ *   4. Stream the old BWT into the new one, inserting the block's BWT characters at the gaps.
+ *
+ * Memory per block byte: 4 (SA) during sorting, then 1 (block) + 1 (block BWT)
+ * + at most 2 (occurrence samples) + 4 (gap array) during the scan and merge.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <unordered_map>
+#include <vector>
+
+#include "bwt_external.h"
+#include "chunk_io.h"
+#include "occ.h"
+#include "sais.h"
+
+namespace {
+
+// Three buffers (text, old BWT, new BWT) are open at a time
+const unsigned long EXTERNAL_IO_MEMORY = 3 * CHUNK_IO_BUFFER;
+
+// Memory per block byte at the peak of a phase, with some slack for the allocator
+const unsigned long EXTERNAL_BYTES_PER_CHAR = 9;
+
+// Blocks are sorted with 32-bit suffix array entries
+const unsigned long EXTERNAL_MAX_BLOCK = 0x7ffffff0UL;
+
+/**
+ * The block as SA-IS sees it: symbol k encodes B[k] and whether T[a + k..] > S,
+ * symbol m stands for S and symbol m + 1 is the sentinel.
+ * 3 * c + 2 (smaller than S) < 3 * c + 3 (S, if S starts with c) < 3 * c + 4 (greater than S).
+ */
+struct BlockText
+{
+  const std::string& B;
+  const std::vector<bool>& greater;
+  int32_t end;
+
+  int32_t operator[](int32_t i) const {
+    int32_t m = static_cast<int32_t>(B.length());
+    if (i < m)
+      return 3 * static_cast<unsigned char>(B[i]) + 2 * greater[i] + 2;
+    return i == m ? end : 0;
+  }
+};
+
+bool read_range(std::ifstream& in, size_t pos, size_t length, char* out) {
+  in.clear();
+  in.seekg(pos);
+  in.read(out, length);
+  return static_cast<size_t>(in.gcount()) == length;
+}
+
+// Reads the bytes holding bits [lo, hi) of a bit file
+bool read_bits(std::fstream& f, size_t lo, size_t hi, std::vector<unsigned char>& bytes) {
+  bytes.resize((hi - 1) / 8 - lo / 8 + 1);
+  f.clear();
+  f.seekg(lo / 8);
+  f.read(reinterpret_cast<char*>(bytes.data()), bytes.size());
+  return static_cast<size_t>(f.gcount()) == bytes.size();
+}
+
+// Writes back bytes read by read_bits
+bool write_bits(std::fstream& f, size_t lo, const std::vector<unsigned char>& bytes) {
+  f.clear();
+  f.seekp(lo / 8);
+  f.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+  return static_cast<bool>(f);
+}
+
+/**
+ * Sets greater[k] to whether T[a + k..] > S for every k in the block.
+ *
+ * @param B The block T[a, b)
+ * @param head The first min(|B|, |S|) characters of S
+ * @param headGreater headGreater[l] is whether S[l..] > S, for l in [1, |head|]
+ * @param wholeS Whether head is all of S
+ */
+std::vector<bool> compare_with_S(const std::string& B, const std::string& head,
+                                 const std::vector<bool>& headGreater, bool wholeS) {
+  size_t m = B.length();
+  size_t h = head.length();
+  std::vector<bool> greater(m, true);
+
+  // Z-array of head, then the longest prefix of head at every position of B
+  std::vector<int32_t> Z(h, 0);
+  for (size_t i{1}, l{0}, r{0}; i < h; ++i) {
+    size_t z = i < r ? std::min<size_t>(Z[i - l], r - i) : 0;
+    while (i + z < h && head[z] == head[i + z])
+      z++;
+    Z[i] = static_cast<int32_t>(z);
+    if (i + z > r) {
+      l = i;
+      r = i + z;
+    }
+  }
+
+  for (size_t k{0}, l{0}, r{0}; k < m; ++k) {
+    size_t z = k < r ? std::min<size_t>(Z[k - l], r - k) : 0;
+    if (k >= r || z == r - k) {
+      while (k + z < m && z < h && B[k + z] == head[z])
+        z++;
+      if (k + z > r) {
+        l = k;
+        r = k + z;
+      }
+    }
+
+    size_t rest = m - k;
+    if (z == rest) {
+      // T[k, b) = S[0, rest), so T[k..] > S exactly when S > S[rest..]
+      greater[k] = !headGreater[rest];
+    } else if (z == h) {
+      // Only possible when S ends inside the block, and a longer string with S as prefix is greater
+      greater[k] = wholeS;
+    } else {
+      greater[k] = static_cast<unsigned char>(B[k + z]) > static_cast<unsigned char>(head[z]);
+    }
+  }
+
+  return greater;
+}
+
+}
+
+unsigned long external_bwt_block(unsigned long memoryLimit) {
+  unsigned long available = memoryLimit > EXTERNAL_IO_MEMORY ? memoryLimit - EXTERNAL_IO_MEMORY : 0;
+  return std::min(std::max(available / EXTERNAL_BYTES_PER_CHAR, 1UL), EXTERNAL_MAX_BLOCK);
+}
+
+long encode_bwt_external(const std::string& inputPath, const std::string& outputPath, unsigned long memoryLimit) {
+  std::ifstream text(inputPath, std::ios::binary);
+  if (!text)
+    return -1;
+  text.seekg(0, std::ios::end);
+  size_t n = static_cast<size_t>(text.tellg());
+
+  // Phase files alternate; the last phase writes outputPath directly
+  std::string tmp[2] = {outputPath + ".tmp0", outputPath + ".tmp1"};
+  std::string gtPath = outputPath + ".gt";
+  int current = 0;
+  {
+    // The BWT of the empty suffix is its sentinel alone
+    std::ofstream init(n == 0 ? outputPath : tmp[current], std::ios::binary);
+    init << '$';
+    if (!init)
+      return -1;
+  }
+  if (n == 0)
+    return 0;
+
+  // Bit j: whether T[j..] > S for the current S (only bits in (b, n) are meaningful)
+  {
+    std::ofstream init(gtPath, std::ios::binary);
+    std::vector<char> zeros(CHUNK_IO_BUFFER, 0);
+    for (size_t left{n / 8 + 1}; left > 0 && init;) {
+      size_t count = std::min(left, zeros.size());
+      init.write(zeros.data(), count);
+      left -= count;
+    }
+    if (!init)
+      return -1;
+  }
+  std::fstream gt(gtPath, std::ios::in | std::ios::out | std::ios::binary);
+
+  // Blocks are [0, first), [first, first + m), ...; all but the first have length m
+  size_t m = external_bwt_block(memoryLimit);
+  size_t first = n % m == 0 ? m : n % m;
+
+  // The first block of S and, for l in [1, |head|], whether S[l..] > S
+  std::string head;
+  std::vector<bool> headGreater(1, false);
+  size_t oldDollar = 0;
+  long dollar = -1;
+
+  for (size_t b{n}; b > 0;) {
+    size_t a = b > first ? b - m : 0;
+    size_t len = b - a;
+    bool emptyS = b == n;
+
+    std::string B(len, '\0');
+    if (!read_range(text, a, len, &B[0]))
+      break;
+
+    // Step 1: compare every block suffix with S; afterwards only S's first symbol is needed
+    std::vector<bool> greater = compare_with_S(B, head, headGreater, b + head.length() == n);
+    unsigned char headFirst = emptyS ? 0 : head[0];
+    int32_t end = emptyS ? 1 : 3 * headFirst + 3;
+    std::string().swap(head);
+    std::vector<bool>().swap(headGreater);
+
+    // Step 2: sort the block suffixes together with S; item p is suffix a + SA[p + 1]
+    std::vector<int32_t> SA(len + 2);
+    sais<int32_t>(BlockText{B, greater, end}, SA.data(), static_cast<int32_t>(len + 2), 3 * 255 + 4);
+    std::vector<bool>().swap(greater);
+
+    size_t items = len + 1;
+    size_t p0 = 0;
+    size_t pS = 0;
+    for (size_t p{0}; p < items; ++p) {
+      if (SA[p + 1] == 0)
+        p0 = p;
+      if (SA[p + 1] == static_cast<int32_t>(len))
+        pS = p;
+    }
+
+    // Items after T[a..] are greater than it; the next phase needs this for its head
+    std::vector<bool> nextGreater(len + 1, false);
+    for (size_t p{p0 + 1}; p < items; ++p)
+      nextGreater[SA[p + 1]] = true;
+
+    // L[p]: the character before item p (T[a..] has none inside this suffix and gets '$')
+    std::string L(items, '$');
+    size_t C[256] = {0};
+    for (size_t p{0}; p < items; ++p) {
+      size_t k = SA[p + 1];
+      if (k > 0)
+        L[p] = B[k - 1];
+      if (k < len)
+        C[static_cast<unsigned char>(B[k])]++;
+    }
+    std::vector<int32_t>().swap(SA);
+
+    // C[c]: block suffixes whose first character is smaller than c
+    size_t sum = 0;
+    for (int c{0}; c < 256; ++c) {
+      size_t count = C[c];
+      C[c] = sum;
+      sum += count;
+    }
+
+    // Rank over the block's BWT; T[a..] has no predecessor inside this suffix
+    OccTable occ(std::move(L), p0);
+
+    // Step 3: gap[q] counts suffixes of S with exactly q block suffixes below them (mod 2^32)
+    std::vector<uint32_t> gap(len + 1, 0);
+    std::unordered_map<size_t, uint64_t> wraps;
+    auto addGap = [&](size_t q) {
+      if (++gap[q] == 0)
+        wraps[q]++;
+    };
+
+    // S itself is item pS; the sentinel is below every block suffix
+    addGap(pS);
+    if (!emptyS)
+      addGap(0);
+
+    // Suffixes T[j..] for j in (b, n), located by LF steps from the sentinel. r is the
+    // number of items (block suffixes and S) below T[j + 1..]; the bit of j says whether
+    // T[j..] > S and is overwritten with whether T[j..] > T[a..] for the next phase.
+    std::vector<char> chunk;
+    std::vector<unsigned char> bits;
+    size_t r = 0;
+    bool ok = true;
+    for (size_t hi{n}; hi > b + 1 && ok;) {
+      size_t lo = std::max(b + 1, (hi - 1) / CHUNK_IO_BUFFER * CHUNK_IO_BUFFER);
+      chunk.resize(hi - lo);
+      ok = read_range(text, lo, hi - lo, chunk.data()) && read_bits(gt, lo, hi, bits);
+      for (size_t j{hi}; j-- > lo;) {
+        unsigned char c = chunk[j - lo];
+        unsigned char& byte = bits[j / 8 - lo / 8];
+        unsigned char mask = 1 << (j % 8);
+        size_t below = C[c] + occ.rank(c, r);
+        r = below + ((byte & mask) != 0);
+        addGap(below);
+        byte = r > p0 ? byte | mask : byte & ~mask;
+      }
+      ok = ok && write_bits(gt, lo, bits);
+      hi = lo;
+    }
+
+    // Bits of (a, b] come from the sorted block
+    ok = ok && read_bits(gt, a + 1, b + 1, bits);
+    for (size_t j{a + 1}; j <= b && ok; ++j) {
+      unsigned char mask = 1 << (j % 8);
+      unsigned char& byte = bits[j / 8 - (a + 1) / 8];
+      byte = nextGreater[j - a] ? byte | mask : byte & ~mask;
+    }
+    ok = ok && write_bits(gt, a + 1, bits);
+    if (!ok)
+      break;
+
+    // Step 4: merge; the old sentinel row now holds the block's last character
+    ChunkReader in(tmp[current]);
+    ChunkWriter out(a == 0 ? outputPath : tmp[1 - current]);
+    size_t row = 0;
+    size_t oldRow = 0;
+    size_t newDollar = 0;
+    for (size_t q{0}; q <= len && ok; ++q) {
+      auto wrap = wraps.find(q);
+      uint64_t g = gap[q] + (wrap == wraps.end() ? 0 : wrap->second << 32);
+      for (uint64_t i{0}; i < g; ++i, ++row, ++oldRow) {
+        char c;
+        if (!in.get(c)) {
+          ok = false;
+          break;
+        }
+        out.put(oldRow == oldDollar ? B[len - 1] : c);
+      }
+
+      if (q < len) {
+        size_t p = q < pS ? q : q + 1;
+        if (p == p0)
+          newDollar = row;
+        out.put(occ.text()[p]);
+        row++;
+      }
+    }
+    if (!out.close() || !ok)
+      break;
+
+    std::remove(tmp[current].c_str());
+    current = 1 - current;
+    oldDollar = newDollar;
+    head.swap(B);
+    headGreater.swap(nextGreater);
+    b = a;
+    if (b == 0)
+      dollar = static_cast<long>(newDollar);
+  }
+
+  gt.close();
+  std::remove(gtPath.c_str());
+  std::remove(tmp[0].c_str());
+  std::remove(tmp[1].c_str());
+  return dollar;
+}
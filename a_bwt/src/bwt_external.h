@@ -0,0 +1,40 @@
+/**
+ * @file bwt_external.h
+ * Declarations of BWT construction for texts that do not fit in memory.
+ */
+
+#pragma once
+
+#include <string>
+
+// Default memory budget of encode_bwt_external (bytes)
+const unsigned long EXTERNAL_BWT_MEMORY = 1UL << 30;
+
+/**
+ * Returns the block length encode_bwt_external uses for a memory budget:
+ * about memoryLimit / 9 text bytes after the I/O buffers are set aside.
+ * The budget covers the builder's own allocations, not the program itself.
+ */
+unsigned long external_bwt_block(unsigned long memoryLimit);
+
+/**
+ * Writes the BWT of the file at inputPath (with '$' appended) to outputPath
+ * without holding the text, its suffix array or its BWT in memory.
+ *
+ * The text is split into blocks of external_bwt_block(memoryLimit) bytes that are
+ * processed from the last to the first. Each block's suffixes are sorted in memory,
+ * then merged into the BWT of the suffixes already processed, which is streamed
+ * from one temporary file into the next. Temporary files live next to outputPath
+ * and are removed afterwards.
+ *
+ * The output holds the same bytes as encode_bwt of the whole text; since the text
+ * may contain '$' itself, the row of the sentinel is returned.
+ *
+ * @param inputPath The text file
+ * @param outputPath The file receiving the BWT
+ * @param memoryLimit The peak memory budget in bytes
+ *
+ * @return The row of the sentinel in the output, or -1 if a file could not be read or written
+ */
+long encode_bwt_external(const std::string& inputPath, const std::string& outputPath,
+                         unsigned long memoryLimit = EXTERNAL_BWT_MEMORY);
@@ -0,0 +1,100 @@
+/**
+ * @file bwt_store.cpp
+ * Code to sample the inverse suffix array of a BWT and extract substrings by LF-mapping.
+ */
+
+#include <algorithm>
+
+#include "bwt_store.h"
+
+// The row of the only '$' in bwt, or npos if there is not exactly one
+static size_t find_sentinel(const std::string& bwt) {
+  size_t dollar = bwt.find('$');
+  if (dollar != std::string::npos && bwt.find('$', dollar + 1) != std::string::npos)
+    return std::string::npos;
+  return dollar;
+}
+
+BWTStore::BWTStore(const std::string& bwt) : BWTStore(bwt, find_sentinel(bwt)) {}
+
+BWTStore::BWTStore(const std::string& bwt, size_t dollar, unsigned long rate)
+    : sampleRate(std::max(rate, 1UL)) {
+  // Row 0 ends with the sentinel only for the empty text
+  if (dollar == 0 || dollar >= bwt.length())
+    return;
+
+  L = OccTable(bwt, dollar);
+  build(dollar);
+}
+
+/**
+ * Fills C and walks the LF-mapping once over the whole text, recording the row
+ * of every sampled suffix.
+ */
+void BWTStore::build(size_t dollar) {
+  const std::string& bwt = L.text();
+  size_t n = bwt.length() - 1;
+
+  // C[c]: rows starting with a character smaller than c ('$' takes row 0)
+  for (size_t i{0}; i < bwt.length(); ++i) {
+    if (i != dollar)
+      C[static_cast<unsigned char>(bwt[i])]++;
+  }
+  size_t sum = 1;
+  for (int c{0}; c < 256; ++c) {
+    size_t count = C[c];
+    C[c] = sum;
+    sum += count;
+  }
+
+  // Row 0 is the suffix at n; each LF step moves one position left
+  isa.assign(n / sampleRate + 2, 0);
+  isa.back() = 0;
+  size_t row = 0;
+  for (size_t j{n}; j-- > 0;) {
+    unsigned char c = bwt[row];
+    row = C[c] + L.rank(c, row);
+    if (j % sampleRate == 0)
+      isa[j / sampleRate] = row;
+  }
+}
+
+std::string BWTStore::extract(size_t i, size_t len) const {
+  size_t n = length();
+  if (i >= n)
+    return "";
+  len = std::min(len, n - i);
+
+  // Start from the first sample at or after i + len (the end of T is always sampled)
+  size_t j = i + len;
+  size_t k = (j + sampleRate - 1) / sampleRate;
+  size_t row;
+  if (k * sampleRate >= n) {
+    j = n;
+    row = isa.back();
+  } else {
+    j = k * sampleRate;
+    row = isa[k];
+  }
+
+  // BWT[row of T[j..]] = T[j - 1]; step left until position i
+  const std::string& bwt = L.text();
+  std::string out(len, '\0');
+  for (; j > i; --j) {
+    unsigned char c = bwt[row];
+    if (j <= i + len)
+      out[j - 1 - i] = static_cast<char>(c);
+    if (j - 1 > i)
+      row = C[c] + L.rank(c, row);
+  }
+
+  return out;
+}
+
+size_t BWTStore::length() const {
+  return L.text().empty() ? 0 : L.text().length() - 1;
+}
+
+size_t BWTStore::bytes() const {
+  return L.bytes() + isa.capacity() * sizeof(size_t) + sizeof(*this) - sizeof(L);
+}
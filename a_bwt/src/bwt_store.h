@@ -0,0 +1,70 @@
+/**
+ * @file bwt_store.h
+ * Declarations of a BWT with sampled inverse suffix array for random-access reads.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "occ.h"
+
+// Default distance between sampled text positions
+const unsigned long BWT_STORE_SAMPLE_RATE = 32;
+
+/**
+ * A text stored as its BWT, from which any substring can be read back without
+ * decoding the rest.
+ *
+ * Every sampleRate-th text position (and the end of the text) keeps the BWT row of
+ * its suffix (a sampled inverse suffix array). extract(i, len) starts at the first
+ * sample at or after i + len and walks the LF-mapping backwards, so it costs
+ * O(len + sampleRate) LF steps. Samples take 8 / sampleRate bytes per character.
+ */
+class BWTStore
+{
+    public:
+        /**
+        * Builds the store from a BWT holding exactly one '$' (as produced by encode_bwt),
+        * sampled every BWT_STORE_SAMPLE_RATE positions. An invalid BWT gives an empty store.
+        *
+        * @param bwt The BWT
+        */
+        BWTStore(const std::string& bwt);
+
+        /**
+        * Builds the store from a BWT whose sentinel is at row dollar; '$' elsewhere is ordinary.
+        * As for decode_bwt(bwt, dollar) and RLBWT(bwt, dollar), the second argument is
+        * always the sentinel's row; the sample rate can only be given third.
+        *
+        * @param bwt The BWT
+        * @param dollar The row of the sentinel
+        * @param sampleRate The distance between sampled text positions
+        */
+        BWTStore(const std::string& bwt, size_t dollar, unsigned long sampleRate = BWT_STORE_SAMPLE_RATE);
+
+        /**
+        * Returns T[i, i + len), cut short at the end of the text ("" if i is past the end).
+        *
+        * @param i The first text position
+        * @param len The number of characters
+        */
+        std::string extract(size_t i, size_t len) const;
+
+        // Returns the length of the text (without the sentinel)
+        size_t length() const;
+
+        // Returns the bytes held by the store
+        size_t bytes() const;
+
+    private:
+        OccTable L;
+        size_t C[256] = {0};
+        unsigned long sampleRate;
+
+        // isa[k]: the BWT row of the suffix starting at k * sampleRate; the last entry is the end of T
+        std::vector<size_t> isa;
+
+        void build(size_t dollar);
+};
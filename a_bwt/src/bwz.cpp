@@ -0,0 +1,514 @@
+/**
+ * @file bwz.cpp
+ * Code to compress and decompress data in independent BWT blocks.
+ *
+ * Per block the pipeline is the one popularised by bzip2:
+ *   1. BWT of the block (the sentinel row is stored separately, so any byte is allowed)
+ *   2. Move-to-front, which turns the BWT's runs of equal bytes into runs of zeros
+ *   3. Zero-run RLE: a run of zeros is written in bijective base 2 with RUNA / RUNB,
+ *      every other MTF value v becomes symbol v + 1, and EOB ends the block
+ *   4. One canonical Huffman code per block, limited to BWZ_MAX_CODE_LENGTH bits
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <queue>
+#include <vector>
+
+#include "bwz.h"
+#include "bwt.h"
+#include "parallel.h"
+
+namespace {
+
+const char BWZ_MAGIC[4] = {'B', 'W', 'Z', '1'};
+const size_t BWZ_HEADER_SIZE = 20;
+const size_t BWZ_BLOCK_HEADER_SIZE = 8;
+
+// Symbols after MTF + RLE: two run digits, MTF values 1..255 as 2..256, end of block
+const int RUNA = 0;
+const int RUNB = 1;
+const int EOB = 257;
+const int BWZ_SYMBOLS = 258;
+
+// Code lengths are stored in 5 bits each
+const int BWZ_MAX_CODE_LENGTH = 17;
+const int BWZ_LENGTH_BITS = 5;
+
+// Every block holds its header, its code lengths and at least the end-of-block code
+const size_t BWZ_MIN_BLOCK_SIZE = BWZ_BLOCK_HEADER_SIZE + (BWZ_SYMBOLS * BWZ_LENGTH_BITS + 1 + 7) / 8;
+
+// Codes up to this length decode with one table lookup
+const int BWZ_LOOKUP_BITS = 11;
+
+void put32(std::string& out, uint32_t v) {
+  for (int i{0}; i < 4; ++i)
+    out += static_cast<char>(v >> (8 * i));
+}
+
+uint32_t get32(const unsigned char* p) {
+  return p[0] | p[1] << 8 | p[2] << 16 | static_cast<uint32_t>(p[3]) << 24;
+}
+
+uint64_t get64(const unsigned char* p) {
+  return get32(p) | static_cast<uint64_t>(get32(p + 4)) << 32;
+}
+
+// Standard CRC-32 (reflected, polynomial 0xEDB88320)
+uint32_t crc32(const char* data, size_t n) {
+  static const std::vector<uint32_t> table = [] {
+    std::vector<uint32_t> t(256);
+    for (uint32_t i{0}; i < 256; ++i) {
+      uint32_t c = i;
+      for (int k{0}; k < 8; ++k)
+        c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+      t[i] = c;
+    }
+    return t;
+  }();
+
+  uint32_t crc = 0xffffffffu;
+  for (size_t i{0}; i < n; ++i)
+    crc = table[(crc ^ static_cast<unsigned char>(data[i])) & 0xff] ^ (crc >> 8);
+  return crc ^ 0xffffffffu;
+}
+
+// Writes codes most significant bit first
+struct BitWriter
+{
+  std::string& out;
+  uint64_t buf = 0;
+  int bits = 0;
+
+  void put(uint32_t value, int count) {
+    buf = (buf << count) | value;
+    bits += count;
+    while (bits >= 8) {
+      bits -= 8;
+      out += static_cast<char>(buf >> bits);
+    }
+  }
+
+  void flush() {
+    if (bits > 0)
+      put(0, 8 - bits);
+  }
+};
+
+// Reads what BitWriter wrote; reading past the end yields zero bits and sets overrun()
+struct BitReader
+{
+  const unsigned char* p;
+  const unsigned char* end;
+  uint64_t buf = 0;
+  int bits = 0;
+  size_t padding = 0;
+
+  void refill() {
+    while (bits <= 56) {
+      uint64_t byte = 0;
+      if (p < end)
+        byte = *p++;
+      else
+        padding++;
+      buf |= byte << (56 - bits);
+      bits += 8;
+    }
+  }
+
+  uint32_t peek(int count) {
+    refill();
+    return static_cast<uint32_t>(buf >> (64 - count));
+  }
+
+  void skip(int count) {
+    buf <<= count;
+    bits -= count;
+  }
+
+  uint32_t get(int count) {
+    uint32_t value = peek(count);
+    skip(count);
+    return value;
+  }
+
+  bool overrun() const {
+    return padding * 8 > static_cast<size_t>(bits);
+  }
+};
+
+/**
+ * Computes Huffman code lengths for freq. If the tree is deeper than maxLength,
+ * the frequencies are halved (keeping every used symbol above zero) and the tree rebuilt.
+ */
+std::vector<int> huffman_lengths(std::vector<uint64_t> freq, int maxLength) {
+  int n = static_cast<int>(freq.size());
+  std::vector<int> length(n, 0);
+
+  while (true) {
+    // Nodes 0..n-1 are leaves; internal nodes are appended
+    std::vector<int> parent(n, -1);
+    typedef std::pair<uint64_t, int> Node;
+    std::priority_queue<Node, std::vector<Node>, std::greater<Node>> heap;
+    for (int s{0}; s < n; ++s) {
+      if (freq[s] > 0)
+        heap.push({freq[s], s});
+    }
+
+    // A lone symbol still needs a one-bit code
+    if (heap.size() == 1) {
+      length[heap.top().second] = 1;
+      return length;
+    }
+
+    while (heap.size() > 1) {
+      Node a = heap.top();
+      heap.pop();
+      Node b = heap.top();
+      heap.pop();
+      int id = static_cast<int>(parent.size());
+      parent.push_back(-1);
+      parent[a.second] = id;
+      parent[b.second] = id;
+      heap.push({a.first + b.first, id});
+    }
+
+    // Parents always have larger ids, so depths resolve from the root down
+    std::vector<int> depth(parent.size(), 0);
+    for (int id{static_cast<int>(parent.size()) - 2}; id >= 0; --id) {
+      if (parent[id] >= 0)
+        depth[id] = depth[parent[id]] + 1;
+    }
+
+    int deepest = 0;
+    for (int s{0}; s < n; ++s) {
+      length[s] = freq[s] > 0 ? depth[s] : 0;
+      deepest = std::max(deepest, length[s]);
+    }
+    if (deepest <= maxLength)
+      return length;
+
+    for (int s{0}; s < n; ++s) {
+      if (freq[s] > 0)
+        freq[s] = freq[s] / 2 + 1;
+    }
+  }
+}
+
+// Assigns canonical codes: shorter codes first, ties broken by symbol
+std::vector<uint32_t> canonical_codes(const std::vector<int>& length) {
+  std::vector<uint32_t> code(length.size(), 0);
+  uint32_t next = 0;
+  for (int len{1}; len <= BWZ_MAX_CODE_LENGTH; ++len) {
+    for (size_t s{0}; s < length.size(); ++s) {
+      if (length[s] == len)
+        code[s] = next++;
+    }
+    next <<= 1;
+  }
+  return code;
+}
+
+/**
+ * Decodes one canonical Huffman code. Short codes come straight from a lookup table;
+ * longer ones walk the code lengths using the first code of each length.
+ */
+class HuffmanDecoder
+{
+  public:
+    // Returns false if the lengths do not form a valid prefix code
+    bool init(const std::vector<int>& length) {
+      count.assign(BWZ_MAX_CODE_LENGTH + 1, 0);
+      for (int len : length)
+        count[len]++;
+      count[0] = 0;
+
+      // Kraft inequality; an over-subscribed code cannot be decoded
+      long available = 1;
+      for (int len{1}; len <= BWZ_MAX_CODE_LENGTH; ++len) {
+        available = available * 2 - count[len];
+        if (available < 0)
+          return false;
+      }
+
+      sorted.clear();
+      for (int len{1}; len <= BWZ_MAX_CODE_LENGTH; ++len) {
+        for (size_t s{0}; s < length.size(); ++s) {
+          if (length[s] == len)
+            sorted.push_back(static_cast<int>(s));
+        }
+      }
+      if (sorted.empty())
+        return false;
+
+      // Table entries hold symbol << 8 | length, or 0 for codes longer than the table
+      std::vector<uint32_t> code = canonical_codes(length);
+      table.assign(1 << BWZ_LOOKUP_BITS, 0);
+      for (size_t s{0}; s < length.size(); ++s) {
+        int len = length[s];
+        if (len == 0 || len > BWZ_LOOKUP_BITS)
+          continue;
+        uint32_t first = code[s] << (BWZ_LOOKUP_BITS - len);
+        for (uint32_t k{0}; k < (1u << (BWZ_LOOKUP_BITS - len)); ++k)
+          table[first + k] = static_cast<uint32_t>(s) << 8 | len;
+      }
+
+      return true;
+    }
+
+    int decode(BitReader& in) const {
+      uint32_t entry = table[in.peek(BWZ_LOOKUP_BITS)];
+      if (entry != 0) {
+        in.skip(entry & 0xff);
+        return entry >> 8;
+      }
+
+      uint32_t peeked = in.peek(BWZ_MAX_CODE_LENGTH);
+      uint32_t first = 0;
+      int index = 0;
+      for (int len{1}; len <= BWZ_MAX_CODE_LENGTH; ++len) {
+        uint32_t code = peeked >> (BWZ_MAX_CODE_LENGTH - len);
+        if (code - first < static_cast<uint32_t>(count[len])) {
+          in.skip(len);
+          return sorted[index + code - first];
+        }
+        index += count[len];
+        first = (first + count[len]) << 1;
+      }
+
+      // Unused bit pattern of an incomplete code
+      return -1;
+    }
+
+  private:
+    std::vector<int> count;
+    std::vector<int> sorted;
+    std::vector<uint32_t> table;
+};
+
+/**
+ * Compresses data[0..n) into one self-contained block.
+ */
+std::string compress_block(const char* data, size_t n) {
+  size_t dollar;
+  std::string L = encode_bwt(std::string(data, n), dollar);
+
+  // Move-to-front over the BWT (skipping the sentinel), emitting zero runs as RUNA / RUNB
+  std::vector<uint16_t> symbols;
+  symbols.reserve(n + 1);
+  unsigned char order[256];
+  for (int c{0}; c < 256; ++c)
+    order[c] = static_cast<unsigned char>(c);
+
+  size_t run = 0;
+  auto flushRun = [&]() {
+    // Bijective base 2: digit 1 is RUNA, digit 2 is RUNB
+    while (run > 0) {
+      if (run & 1) {
+        symbols.push_back(RUNA);
+        run = (run - 1) / 2;
+      } else {
+        symbols.push_back(RUNB);
+        run = (run - 2) / 2;
+      }
+    }
+  };
+
+  for (size_t i{0}; i < L.length(); ++i) {
+    if (i == dollar)
+      continue;
+    unsigned char c = L[i];
+    int v = 0;
+    while (order[v] != c)
+      v++;
+    if (v == 0) {
+      run++;
+      continue;
+    }
+    flushRun();
+    std::memmove(order + 1, order, v);
+    order[0] = c;
+    symbols.push_back(static_cast<uint16_t>(v + 1));
+  }
+  flushRun();
+  symbols.push_back(EOB);
+
+  std::vector<uint64_t> freq(BWZ_SYMBOLS, 0);
+  for (uint16_t s : symbols)
+    freq[s]++;
+  std::vector<int> length = huffman_lengths(freq, BWZ_MAX_CODE_LENGTH);
+  std::vector<uint32_t> code = canonical_codes(length);
+
+  std::string out;
+  out.reserve(n / 2 + 256);
+  put32(out, static_cast<uint32_t>(dollar));
+  put32(out, crc32(data, n));
+
+  BitWriter bits{out};
+  for (int len : length)
+    bits.put(len, BWZ_LENGTH_BITS);
+  for (uint16_t s : symbols)
+    bits.put(code[s], length[s]);
+  bits.flush();
+
+  return out;
+}
+
+/**
+ * Decompresses one block holding n bytes into out[0..n).
+ *
+ * @return false if the block is malformed or its CRC does not match
+ */
+bool decompress_block(const unsigned char* p, size_t size, char* out, size_t n) {
+  if (size < BWZ_BLOCK_HEADER_SIZE)
+    return false;
+  size_t dollar = get32(p);
+  uint32_t crc = get32(p + 4);
+  if (dollar == 0 || dollar > n)
+    return false;
+
+  BitReader in{p + BWZ_BLOCK_HEADER_SIZE, p + size};
+  std::vector<int> length(BWZ_SYMBOLS);
+  for (int s{0}; s < BWZ_SYMBOLS; ++s)
+    length[s] = static_cast<int>(in.get(BWZ_LENGTH_BITS));
+  HuffmanDecoder decoder;
+  for (int len : length) {
+    if (len > BWZ_MAX_CODE_LENGTH)
+      return false;
+  }
+  if (!decoder.init(length))
+    return false;
+
+  // Undo RLE and move-to-front straight into the BWT, leaving a gap for the sentinel
+  std::string L(n + 1, '\0');
+  size_t filled = 0;
+  auto emit = [&](unsigned char c, size_t count) {
+    if (count > n - filled)
+      return false;
+    for (size_t k{0}; k < count; ++k, ++filled)
+      L[filled < dollar ? filled : filled + 1] = static_cast<char>(c);
+    return true;
+  };
+
+  unsigned char order[256];
+  for (int c{0}; c < 256; ++c)
+    order[c] = static_cast<unsigned char>(c);
+
+  size_t run = 0;
+  int runDigit = 0;
+  while (true) {
+    int s = decoder.decode(in);
+    if (s < 0 || in.overrun())
+      return false;
+
+    if (s == RUNA || s == RUNB) {
+      if (runDigit >= 40)
+        return false;
+      run += static_cast<size_t>(s + 1) << runDigit++;
+      continue;
+    }
+    if (run > 0 && !emit(order[0], run))
+      return false;
+    run = 0;
+    runDigit = 0;
+
+    if (s == EOB)
+      break;
+    int v = s - 1;
+    unsigned char c = order[v];
+    std::memmove(order + 1, order, v);
+    order[0] = c;
+    if (!emit(c, 1))
+      return false;
+  }
+  if (filled != n)
+    return false;
+
+  std::string T = decode_bwt(L, dollar);
+  if (T.length() != n || crc32(T.data(), n) != crc)
+    return false;
+
+  std::memcpy(out, T.data(), n);
+  return true;
+}
+
+}
+
+std::string bwz_compress(const std::string& data, unsigned long blockSize, unsigned threads) {
+  blockSize = std::min(std::max(blockSize, 1UL), BWZ_MAX_BLOCK_SIZE);
+  size_t count = (data.length() + blockSize - 1) / blockSize;
+
+  std::vector<std::string> blocks(count);
+  parallel_for(count, threads, [&](size_t k) {
+    size_t begin = k * blockSize;
+    size_t n = std::min<size_t>(blockSize, data.length() - begin);
+    blocks[k] = compress_block(data.data() + begin, n);
+  });
+
+  std::string out(BWZ_MAGIC, 4);
+  put32(out, static_cast<uint32_t>(blockSize));
+  put32(out, static_cast<uint32_t>(data.length()));
+  put32(out, static_cast<uint32_t>(static_cast<uint64_t>(data.length()) >> 32));
+  put32(out, static_cast<uint32_t>(count));
+  for (auto& block : blocks)
+    put32(out, static_cast<uint32_t>(block.length()));
+  for (auto& block : blocks)
+    out += block;
+
+  return out;
+}
+
+bool bwz_decompress(const std::string& archive, std::string& data, unsigned threads) {
+  const unsigned char* p = reinterpret_cast<const unsigned char*>(archive.data());
+  if (archive.length() < BWZ_HEADER_SIZE || std::memcmp(p, BWZ_MAGIC, 4) != 0)
+    return false;
+
+  uint64_t blockSize = get32(p + 4);
+  uint64_t total = get64(p + 8);
+  uint64_t count = get32(p + 16);
+  if (blockSize == 0 || blockSize > BWZ_MAX_BLOCK_SIZE || count != total / blockSize + (total % blockSize != 0))
+    return false;
+  if (archive.length() < BWZ_HEADER_SIZE + 4 * count)
+    return false;
+
+  // Block offsets come from the size table, so every block decodes independently
+  std::vector<size_t> offset(count + 1);
+  offset[0] = BWZ_HEADER_SIZE + 4 * count;
+  for (size_t k{0}; k < count; ++k) {
+    uint32_t size = get32(p + BWZ_HEADER_SIZE + 4 * k);
+    if (size < BWZ_MIN_BLOCK_SIZE)
+      return false;
+    offset[k + 1] = offset[k] + size;
+  }
+  if (offset[count] != archive.length())
+    return false;
+
+  // Every block's sentinel must fall inside it
+  for (size_t k{0}; k < count; ++k) {
+    size_t dollar = get32(p + offset[k]);
+    if (dollar == 0 || dollar > std::min<uint64_t>(blockSize, total - k * blockSize))
+      return false;
+  }
+
+  // The header alone cannot prove the output size, so the buffer is left untouched until
+  // blocks decode into it: a forged header costs address space, not memory
+  std::unique_ptr<char[]> out(new (std::nothrow) char[total]);
+  if (!out)
+    return false;
+  std::atomic<bool> ok{true};
+  parallel_for(count, threads, [&](size_t k) {
+    size_t begin = k * blockSize;
+    size_t n = std::min<size_t>(blockSize, total - begin);
+    if (ok && !decompress_block(p + offset[k], offset[k + 1] - offset[k], out.get() + begin, n))
+      ok = false;
+  });
+  if (!ok)
+    return false;
+
+  data.assign(out.get(), total);
+  return true;
+}
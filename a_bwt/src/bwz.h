@@ -0,0 +1,42 @@
+/**
+ * @file bwz.h
+ * Declarations of a bzip2-style block compressor built on the BWT.
+ */
+
+#pragma once
+
+#include <string>
+
+// Default and largest block sizes in bytes
+const unsigned long BWZ_BLOCK_SIZE = 1UL << 20;
+const unsigned long BWZ_MAX_BLOCK_SIZE = 1UL << 26;
+
+/**
+ * Compresses data in independent blocks: BWT, move-to-front, zero-run RLE and
+ * canonical Huffman coding. Blocks are transformed by a pool of worker threads,
+ * and the archive records every block's compressed size so that each block can
+ * also be decompressed on its own.
+ *
+ * Archive layout (integers little-endian):
+ *   "BWZ1", u32 block size, u64 data size, u32 block count,
+ *   u32 compressed size of every block, then the blocks back to back.
+ * Each block is u32 sentinel row, u32 CRC-32 of its data, then the Huffman bitstream.
+ *
+ * @param data The bytes to compress
+ * @param blockSize Bytes per block (clamped to [1, BWZ_MAX_BLOCK_SIZE])
+ * @param threads The number of worker threads (0 uses every hardware thread)
+ *
+ * @return The archive
+ */
+std::string bwz_compress(const std::string& data, unsigned long blockSize = BWZ_BLOCK_SIZE, unsigned threads = 0);
+
+/**
+ * Decompresses an archive written by bwz_compress, decoding blocks in parallel.
+ *
+ * @param archive The archive bytes
+ * @param data Receives the original bytes
+ * @param threads The number of worker threads (0 uses every hardware thread)
+ *
+ * @return false if the archive is truncated, malformed or fails its checksums
+ */
+bool bwz_decompress(const std::string& archive, std::string& data, unsigned threads = 0);
@@ -0,0 +1,69 @@
+/**
+ * @file chunk_io.h
+ * Buffered sequential file reads and writes shared by the on-disk BWT builders.
+ */
+
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Bytes per buffered read or write
+const size_t CHUNK_IO_BUFFER = 1 << 16;
+
+// Sequential reads through a fixed buffer
+class ChunkReader
+{
+  public:
+    ChunkReader(const std::string& path) : in(path, std::ios::binary), buf(CHUNK_IO_BUFFER) {}
+
+    bool get(char& c) {
+      if (pos == size) {
+        in.read(buf.data(), buf.size());
+        size = static_cast<size_t>(in.gcount());
+        pos = 0;
+        if (size == 0)
+          return false;
+      }
+      c = buf[pos++];
+      return true;
+    }
+
+  private:
+    std::ifstream in;
+    std::vector<char> buf;
+    size_t pos = 0;
+    size_t size = 0;
+};
+
+// Sequential writes through a fixed buffer
+class ChunkWriter
+{
+  public:
+    ChunkWriter(const std::string& path) : out(path, std::ios::binary) {
+      buf.reserve(CHUNK_IO_BUFFER);
+    }
+
+    void put(char c) {
+      buf.push_back(c);
+      if (buf.size() == CHUNK_IO_BUFFER)
+        flush();
+    }
+
+    // Returns false if any write failed
+    bool close() {
+      flush();
+      out.close();
+      return static_cast<bool>(out);
+    }
+
+  private:
+    std::ofstream out;
+    std::vector<char> buf;
+
+    void flush() {
+      out.write(buf.data(), buf.size());
+      buf.clear();
+    }
+};
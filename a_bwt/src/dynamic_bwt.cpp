@@ -0,0 +1,85 @@
+/**
+ * @file dynamic_bwt.cpp
+ * Code to grow the BWT of a reversed text one character at a time.
+ */
+
+#include <algorithm>
+
+#include "dynamic_bwt.h"
+
+DynamicBWT::DynamicBWT(const std::string& T, size_t leafBytes) : L(leafBytes) {
+  L.insert(0, '$');
+  append(T);
+}
+
+size_t DynamicBWT::C(unsigned char c) const {
+  size_t sum = 1;
+  for (int b{0}; b < c; ++b)
+    sum += counts[b];
+  return sum;
+}
+
+size_t DynamicBWT::rank(unsigned char c, size_t i) const {
+  return L.rank(c, i) - (c == '$' && dollar < i);
+}
+
+/**
+ * Prepends c to the reversed text X. The new suffix cX sorts after every suffix
+ * starting with a smaller character and after the suffixes cY with Y < X, which are
+ * the c's above X's row: its row is C[c] + rank_c(dollar). X's row now ends with c,
+ * and the sentinel moves to the new row.
+ */
+void DynamicBWT::append(char c) {
+  unsigned char b = c;
+  size_t row = C(b) + rank(b, dollar);
+  L.set(dollar, c);
+  L.insert(row, '$');
+  dollar = row;
+  counts[b]++;
+}
+
+void DynamicBWT::append(const std::string& s) {
+  for (char c : s)
+    append(c);
+}
+
+size_t DynamicBWT::length() const {
+  return L.length() - 1;
+}
+
+size_t DynamicBWT::count(const std::string& P) const {
+  if (P.empty())
+    return 0;
+
+  // Backward search for P reversed: its last character is P's first
+  size_t lo = 0;
+  size_t hi = L.length();
+  for (size_t k{0}; k < P.length() && lo < hi; ++k) {
+    unsigned char c = P[k];
+    lo = C(c) + rank(c, lo);
+    hi = C(c) + rank(c, hi);
+  }
+
+  return hi > lo ? hi - lo : 0;
+}
+
+std::string DynamicBWT::text() const {
+  // Row 0 is the bare sentinel, whose BWT character is the last of T reversed: T[0]
+  std::string T(length(), '\0');
+  size_t row = 0;
+  for (size_t k{0}; k < T.length(); ++k) {
+    unsigned char c = L.at(row);
+    T[k] = static_cast<char>(c);
+    row = C(c) + rank(c, row);
+  }
+  return T;
+}
+
+std::string DynamicBWT::bwt(size_t& sentinel) const {
+  sentinel = dollar;
+  return L.str();
+}
+
+size_t DynamicBWT::bytes() const {
+  return sizeof(*this) - sizeof(L) + L.bytes();
+}
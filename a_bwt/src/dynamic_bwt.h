@@ -0,0 +1,68 @@
+/**
+ * @file dynamic_bwt.h
+ * Declarations of a BWT that grows as text is appended.
+ */
+
+#pragma once
+
+#include <string>
+
+#include "dynamic_sequence.h"
+
+/**
+ * The BWT of a growing text T, updated in O(log n) per appended character.
+ *
+ * Appending to T changes the order of every suffix, but prepending a character to a
+ * text only adds one suffix: its row is found by one rank, and the sentinel moves
+ * there. So the structure keeps the BWT of T reversed, where each append is a prepend.
+ * count() searches it with the pattern's characters in forward order, which is
+ * backward search on the reversed pattern.
+ */
+class DynamicBWT
+{
+    public:
+        /**
+        * Starts from the text T (empty by default).
+        *
+        * @param T The initial text
+        * @param leafBytes The leaf size of the underlying DynamicSequence
+        */
+        DynamicBWT(const std::string& T = "", size_t leafBytes = DYNAMIC_LEAF_BYTES);
+
+        // Appends c to the end of T
+        void append(char c);
+
+        // Appends every character of s to the end of T
+        void append(const std::string& s);
+
+        // Returns the length of T
+        size_t length() const;
+
+        // Returns the number of occurrences of P in T (0 for an empty P)
+        size_t count(const std::string& P) const;
+
+        // Returns T, by inverting the BWT
+        std::string text() const;
+
+        /**
+        * Returns the BWT of T reversed (what encode_bwt gives for the reversed text).
+        *
+        * @param dollar Receives the row of the sentinel
+        */
+        std::string bwt(size_t& dollar) const;
+
+        // Returns the bytes held by the structure
+        size_t bytes() const;
+
+    private:
+        // The BWT of T reversed, with a placeholder '$' in the sentinel's row
+        DynamicSequence L;
+        size_t dollar = 0;
+        size_t counts[256] = {0};
+
+        // Returns the rows starting with a character smaller than c ('$' takes row 0)
+        size_t C(unsigned char c) const;
+
+        // Returns the occurrences of c in rows [0, i), never counting the sentinel
+        size_t rank(unsigned char c, size_t i) const;
+};
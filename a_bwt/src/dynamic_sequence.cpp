@@ -0,0 +1,159 @@
+/**
+ * @file dynamic_sequence.cpp
+ * Code for the B-tree of byte blocks behind DynamicSequence.
+ */
+
+#include <algorithm>
+
+#include "dynamic_sequence.h"
+
+DynamicSequence::DynamicSequence(size_t leafBytes, size_t fanout)
+    : root(new Node(true)), leafBytes(std::max<size_t>(leafBytes, 2)), fanout(std::max<size_t>(fanout, 3)) {}
+
+DynamicSequence::~DynamicSequence() {
+  std::vector<Node*> stack{root};
+  while (!stack.empty()) {
+    Node* node = stack.back();
+    stack.pop_back();
+    stack.insert(stack.end(), node->children.begin(), node->children.end());
+    delete node;
+  }
+}
+
+size_t DynamicSequence::length() const {
+  return root->size;
+}
+
+char DynamicSequence::at(size_t i) const {
+  const Node* node = root;
+  while (!node->leaf) {
+    size_t k = 0;
+    while (i >= node->children[k]->size)
+      i -= node->children[k++]->size;
+    node = node->children[k];
+  }
+  return node->data[i];
+}
+
+size_t DynamicSequence::rank(unsigned char c, size_t i) const {
+  size_t r = 0;
+  const Node* node = root;
+  while (!node->leaf) {
+    size_t k = 0;
+    while (k + 1 < node->children.size() && i >= node->children[k]->size) {
+      r += node->children[k]->count[c];
+      i -= node->children[k++]->size;
+    }
+    node = node->children[k];
+  }
+  return r + std::count(node->data.begin(), node->data.begin() + i, static_cast<char>(c));
+}
+
+void DynamicSequence::insert(size_t i, char c) {
+  Node* right = insert(root, i, c);
+  if (!right)
+    return;
+
+  // The root split: grow the tree by one level
+  Node* top = new Node(false);
+  top->children = {root, right};
+  top->size = root->size + right->size;
+  for (int b{0}; b < 256; ++b)
+    top->count[b] = root->count[b] + right->count[b];
+  root = top;
+}
+
+/**
+ * Inserts c before position i below node.
+ *
+ * @return The new right half of node if it overflowed, otherwise nullptr
+ */
+DynamicSequence::Node* DynamicSequence::insert(Node* node, size_t i, char c) {
+  node->size++;
+  node->count[static_cast<unsigned char>(c)]++;
+
+  if (node->leaf) {
+    node->data.insert(node->data.begin() + i, c);
+    return node->data.size() > leafBytes ? split(node) : nullptr;
+  }
+
+  size_t k = 0;
+  while (i > node->children[k]->size)
+    i -= node->children[k++]->size;
+  Node* right = insert(node->children[k], i, c);
+  if (!right)
+    return nullptr;
+
+  node->children.insert(node->children.begin() + k + 1, right);
+  return node->children.size() > fanout ? split(node) : nullptr;
+}
+
+// Moves the upper half of node into a new node and returns it
+DynamicSequence::Node* DynamicSequence::split(Node* node) {
+  Node* right = new Node(node->leaf);
+  if (node->leaf) {
+    size_t half = node->data.size() / 2;
+    right->data = node->data.substr(half);
+    node->data.resize(half);
+    for (unsigned char b : right->data)
+      right->count[b]++;
+    right->size = right->data.size();
+  } else {
+    size_t half = node->children.size() / 2;
+    right->children.assign(node->children.begin() + half, node->children.end());
+    node->children.resize(half);
+    for (Node* child : right->children) {
+      right->size += child->size;
+      for (int b{0}; b < 256; ++b)
+        right->count[b] += child->count[b];
+    }
+  }
+
+  node->size -= right->size;
+  for (int b{0}; b < 256; ++b)
+    node->count[b] -= right->count[b];
+
+  return right;
+}
+
+void DynamicSequence::set(size_t i, char c) {
+  unsigned char old = at(i);
+  Node* node = root;
+  while (true) {
+    node->count[old]--;
+    node->count[static_cast<unsigned char>(c)]++;
+    if (node->leaf)
+      break;
+    size_t k = 0;
+    while (i >= node->children[k]->size)
+      i -= node->children[k++]->size;
+    node = node->children[k];
+  }
+  node->data[i] = c;
+}
+
+std::string DynamicSequence::str() const {
+  std::string out;
+  out.reserve(root->size);
+  std::vector<const Node*> stack{root};
+  while (!stack.empty()) {
+    const Node* node = stack.back();
+    stack.pop_back();
+    if (node->leaf)
+      out += node->data;
+    stack.insert(stack.end(), node->children.rbegin(), node->children.rend());
+  }
+  return out;
+}
+
+size_t DynamicSequence::bytes() const {
+  size_t total = sizeof(*this);
+  std::vector<const Node*> stack{root};
+  while (!stack.empty()) {
+    const Node* node = stack.back();
+    stack.pop_back();
+    total += sizeof(Node) + node->data.capacity() + node->children.capacity() * sizeof(Node*);
+    stack.insert(stack.end(), node->children.begin(), node->children.end());
+  }
+  return total;
+}
@@ -0,0 +1,72 @@
+/**
+ * @file dynamic_sequence.h
+ * Declarations of a byte sequence with rank under insertion.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Default bytes per leaf and children per inner node
+const size_t DYNAMIC_LEAF_BYTES = 8192;
+const size_t DYNAMIC_FANOUT = 16;
+
+/**
+ * A byte string that supports access, rank and in-place update as well as insertion
+ * at any position, each in O(log n + leafBytes) time.
+ *
+ * The bytes live in the leaves of a B-tree, in order, at most leafBytes per leaf.
+ * Every node keeps its length and the count of every byte below it, so rank sums
+ * the counts of the children left of its path and scans part of one leaf. Counts
+ * add 2 KB per node: about a third of a default leaf.
+ */
+class DynamicSequence
+{
+    public:
+        DynamicSequence(size_t leafBytes = DYNAMIC_LEAF_BYTES, size_t fanout = DYNAMIC_FANOUT);
+        ~DynamicSequence();
+
+        DynamicSequence(const DynamicSequence&) = delete;
+        DynamicSequence& operator=(const DynamicSequence&) = delete;
+
+        // Returns the number of bytes
+        size_t length() const;
+
+        // Returns the byte at i < length()
+        char at(size_t i) const;
+
+        // Returns the occurrences of c in [0, i), for i <= length()
+        size_t rank(unsigned char c, size_t i) const;
+
+        // Inserts c before position i <= length()
+        void insert(size_t i, char c);
+
+        // Replaces the byte at i < length() by c
+        void set(size_t i, char c);
+
+        // Returns the whole sequence
+        std::string str() const;
+
+        // Returns the bytes held by the tree
+        size_t bytes() const;
+
+    private:
+        struct Node
+        {
+            Node(bool isLeaf) : leaf(isLeaf) {}
+
+            bool leaf;
+            size_t size = 0;
+            size_t count[256] = {0};
+            std::string data;
+            std::vector<Node*> children;
+        };
+
+        Node* root;
+        size_t leafBytes;
+        size_t fanout;
+
+        Node* insert(Node* node, size_t i, char c);
+        Node* split(Node* node);
+};
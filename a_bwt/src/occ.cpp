@@ -0,0 +1,55 @@
+/**
+ * @file occ.cpp
+ * Code to build the sampled occurrence table.
+ */
+
+#include <algorithm>
+
+#include "occ.h"
+
+// Every sample holds sigma 4- or 8-byte counters; keep them within this many bytes per character
+static const size_t OCC_BYTES_PER_CHAR = 2;
+
+OccTable::OccTable(std::string str, size_t skipped) : s(std::move(str)), skip(skipped) {
+  // Dense codes for the characters present
+  std::fill(code, code + 256, -1);
+  for (size_t p{0}; p < s.length(); ++p) {
+    unsigned char c = s[p];
+    if (p != skip && code[c] < 0)
+      code[c] = static_cast<int>(sigma++);
+  }
+  size_t counterBytes = s.length() < OCC_WIDE_LENGTH ? 4 : 8;
+  while (step < counterBytes * sigma / OCC_BYTES_PER_CHAR)
+    step *= 2;
+
+  if (counterBytes == 4)
+    fill(samples);
+  else
+    fill(wide);
+}
+
+/**
+ * Fills table[b * sigma + code[c]] with the occurrences of c in s[0, b * step),
+ * skipping position skip.
+ */
+template <typename Count>
+void OccTable::fill(std::vector<Count>& table) {
+  table.assign((s.length() / step + 1) * sigma, 0);
+  std::vector<Count> counts(sigma, 0);
+  for (size_t p{0}; p < s.length(); ++p) {
+    if (p % step == 0)
+      std::copy(counts.begin(), counts.end(), table.begin() + p / step * sigma);
+    if (p != skip)
+      counts[code[static_cast<unsigned char>(s[p])]]++;
+  }
+  if (s.length() % step == 0)
+    std::copy(counts.begin(), counts.end(), table.begin() + s.length() / step * sigma);
+}
+
+const std::string& OccTable::text() const {
+  return s;
+}
+
+size_t OccTable::bytes() const {
+  return s.capacity() + samples.capacity() * sizeof(uint32_t) + wide.capacity() * sizeof(uint64_t) + sizeof(*this);
+}
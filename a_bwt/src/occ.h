@@ -0,0 +1,65 @@
+/**
+ * @file occ.h
+ * Declarations of a rank (occurrence count) structure over a byte string.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Strings at least this long keep 64-bit samples, since 32-bit counts would wrap
+const size_t OCC_WIDE_LENGTH = 1UL << 32;
+
+/**
+ * Answers "how many times does c occur in s[0, r)" in O(step) time.
+ *
+ * Counts are sampled every step positions, but only for the characters that occur
+ * in s, and step grows with the alphabet so samples stay within 2 bytes per character:
+ * DNA gets a step of 16, arbitrary bytes a step of 512. Samples are 32-bit counters
+ * below OCC_WIDE_LENGTH characters and 64-bit counters (with twice the step) above.
+ */
+class OccTable
+{
+    public:
+        /**
+        * Builds the table over s.
+        *
+        * @param s The string (typically a BWT); the table keeps its own copy
+        * @param skip A position left out of every count (e.g. the BWT's sentinel), or npos
+        */
+        OccTable(std::string s = "", size_t skip = std::string::npos);
+
+        // Returns the occurrences of c in s[0, r), not counting position skip
+        size_t rank(unsigned char c, size_t r) const {
+            int k = code[c];
+            if (k < 0)
+                return 0;
+            size_t block = r / step;
+            size_t count = wide.empty() ? samples[block * sigma + k] : wide[block * sigma + k];
+            for (size_t p{block * step}; p < r; ++p)
+                count += static_cast<unsigned char>(s[p]) == c;
+            if (skip < r && skip >= block * step && static_cast<unsigned char>(s[skip]) == c)
+                count--;
+            return count;
+        }
+
+        // Returns the string the table was built over
+        const std::string& text() const;
+
+        // Returns the bytes held by the table, including its copy of s
+        size_t bytes() const;
+
+    private:
+        std::string s;
+        size_t skip;
+        int code[256];
+        size_t sigma = 0;
+        size_t step = 16;
+        std::vector<uint32_t> samples;
+        std::vector<uint64_t> wide;
+
+        template <typename Count>
+        void fill(std::vector<Count>& table);
+};
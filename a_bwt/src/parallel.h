@@ -0,0 +1,43 @@
+/**
+ * @file parallel.h
+ * A minimal work-sharing loop over std::thread.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+/**
+ * Runs work(k) for every k in [0, count) on up to threads threads.
+ * Indices are handed out one at a time, so uneven items still balance.
+ *
+ * @param count The number of work items
+ * @param threads The number of worker threads (0 uses every hardware thread)
+ * @param work Called once per item, possibly concurrently
+ */
+template <typename Work>
+void parallel_for(size_t count, unsigned threads, Work work) {
+  if (threads == 0)
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  threads = static_cast<unsigned>(std::min<size_t>(threads, count));
+
+  std::atomic<size_t> next{0};
+  auto worker = [&]() {
+    for (size_t k = next++; k < count; k = next++)
+      work(k);
+  };
+
+  if (threads <= 1) {
+    worker();
+    return;
+  }
+
+  std::vector<std::thread> pool;
+  for (unsigned t{0}; t < threads; ++t)
+    pool.emplace_back(worker);
+  for (auto& th : pool)
+    th.join();
+}
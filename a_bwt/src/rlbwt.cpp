@@ -0,0 +1,190 @@
+/**
+ * @file rlbwt.cpp
+ * Code to build and query the run-length compressed BWT.
+ */
+
+#include <algorithm>
+
+#include "rlbwt.h"
+
+/**
+ * Returns how many entries of v[lo, hi) have key(entry) <= value, for entries sorted by key.
+ * Written out rather than std::upper_bound, whose debug-mode checks scan the whole range.
+ */
+template <typename Key>
+static size_t count_at_most(const std::vector<size_t>& v, size_t lo, size_t hi, size_t value, Key key) {
+  size_t first = lo;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (key(v[mid]) <= value)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo - first;
+}
+
+RLBWT::RLBWT(const std::string& bwt) {
+  size_t first = bwt.find('$');
+  if (first == std::string::npos || bwt.find('$', first + 1) != std::string::npos)
+    return;
+
+  dollar = first;
+  build(bwt);
+}
+
+RLBWT::RLBWT(const std::string& bwt, size_t sentinelRow) {
+  if (sentinelRow >= bwt.length())
+    return;
+
+  dollar = sentinelRow;
+  build(bwt);
+}
+
+void RLBWT::build(const std::string& bwt) {
+  size_t n = bwt.length();
+
+  // Row 0 ends with the sentinel only for the empty text
+  if (dollar == 0 && n > 1)
+    return;
+  size_t count[256] = {0};
+
+  // A run ends at every change of character and around the sentinel
+  for (size_t i{0}; i < n; ++i) {
+    unsigned char c = bwt[i];
+    if (i == 0 || i == dollar || i == dollar + 1 || bwt[i] != bwt[i - 1]) {
+      if (i == dollar) {
+        dollarRun = heads.length();
+        before.push_back(0);
+      } else {
+        byChar[c].push_back(heads.length());
+        before.push_back(count[c]);
+      }
+      heads += i == dollar ? '$' : bwt[i];
+      starts.push_back(i);
+    }
+    if (i != dollar)
+      count[c]++;
+  }
+  starts.push_back(n);
+
+  // C[c]: rows starting with a character smaller than c ('$' takes row 0)
+  size_t sum = 1;
+  for (int c{0}; c < 256; ++c) {
+    C[c] = sum;
+    sum += count[c];
+  }
+
+  // One entry per block of 2^shift rows, with at most r blocks
+  while ((n >> shift) > heads.length())
+    shift++;
+  blockRun.resize(((n - 1) >> shift) + 1);
+  for (size_t k{0}, b{0}; b < blockRun.size(); ++b) {
+    while (starts[k + 1] <= b << shift)
+      k++;
+    blockRun[b] = k;
+  }
+
+  heads.shrink_to_fit();
+  starts.shrink_to_fit();
+  before.shrink_to_fit();
+  for (auto& runs : byChar)
+    runs.shrink_to_fit();
+}
+
+size_t RLBWT::length() const {
+  return starts.empty() ? 0 : starts.back();
+}
+
+size_t RLBWT::runs() const {
+  return heads.length();
+}
+
+double RLBWT::runRatio() const {
+  return length() == 0 ? 0 : static_cast<double>(runs()) / length();
+}
+
+size_t RLBWT::sentinel() const {
+  return dollar;
+}
+
+size_t RLBWT::runOf(size_t i) const {
+  // Only the runs overlapping i's block can hold it
+  size_t b = i >> shift;
+  size_t lo = blockRun[b];
+  size_t hi = b + 1 < blockRun.size() ? blockRun[b + 1] + 1 : heads.length();
+  return lo + count_at_most(starts, lo, hi, i, [](size_t start) { return start; }) - 1;
+}
+
+char RLBWT::access(size_t i) const {
+  if (i >= length())
+    return '\0';
+
+  return heads[runOf(i)];
+}
+
+size_t RLBWT::rank(unsigned char c, size_t i) const {
+  if (i == 0 || byChar[c].empty())
+    return 0;
+  i = std::min(i, length());
+
+  // The last run of c starting before i
+  size_t k = runOf(i - 1);
+  const std::vector<size_t>& runs = byChar[c];
+  size_t found = count_at_most(runs, 0, runs.size(), k, [](size_t run) { return run; });
+  if (found == 0)
+    return 0;
+  size_t last = runs[found - 1];
+
+  return before[last] + std::min(i, starts[last + 1]) - starts[last];
+}
+
+size_t RLBWT::select(unsigned char c, size_t j) const {
+  const std::vector<size_t>& runs = byChar[c];
+
+  // The last run of c whose earlier occurrences are at most j
+  size_t found = count_at_most(runs, 0, runs.size(), j, [this](size_t run) { return before[run]; });
+  if (found == 0)
+    return std::string::npos;
+  size_t run = runs[found - 1];
+  size_t offset = j - before[run];
+  if (offset >= starts[run + 1] - starts[run])
+    return std::string::npos;
+
+  return starts[run] + offset;
+}
+
+size_t RLBWT::LF(size_t i) const {
+  if (i >= length())
+    return std::string::npos;
+
+  size_t k = runOf(i);
+  if (k == dollarRun)
+    return 0;
+
+  unsigned char c = heads[k];
+  return C[c] + before[k] + (i - starts[k]);
+}
+
+std::string RLBWT::decode() const {
+  if (length() == 0)
+    return "";
+
+  // Row 0 is '$' + T, so its last character is the end of T
+  std::string T(length() - 1, '\0');
+  size_t row = 0;
+  for (size_t k{T.length()}; k-- > 0;) {
+    T[k] = access(row);
+    row = LF(row);
+  }
+
+  return T;
+}
+
+size_t RLBWT::bytes() const {
+  size_t total = sizeof(*this) + heads.capacity() +
+                 (starts.capacity() + before.capacity() + blockRun.capacity()) * sizeof(size_t);
+  for (auto& runs : byChar)
+    total += runs.capacity() * sizeof(size_t);
+  return total;
+}
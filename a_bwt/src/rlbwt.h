@@ -0,0 +1,93 @@
+/**
+ * @file rlbwt.h
+ * Declarations of the run-length compressed BWT.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+/**
+ * A BWT stored as its r runs of equal characters instead of its n characters.
+ *
+ * Run k holds character heads[k] over rows [starts[k], starts[k + 1]), and before[k]
+ * counts that character in earlier runs. Queries locate their run by binary search,
+ * narrowed for access and LF by a table of the first run in each of at most r equal
+ * blocks of rows, so all queries cost O(log r) time and the structure takes O(r) words. The sentinel is kept as a run of its own and is never counted as '$'.
+ */
+class RLBWT
+{
+    public:
+        /**
+        * Builds the RLBWT of a BWT holding exactly one '$' (as produced by encode_bwt).
+        * An invalid BWT (including a non-empty text with '$' in row 0) gives an empty RLBWT.
+        */
+        RLBWT(const std::string& bwt);
+
+        /**
+        * Builds the RLBWT of a BWT whose sentinel is at row dollar; '$' elsewhere is ordinary.
+        * Rows past the end, and row 0 for a non-empty text, give an empty RLBWT.
+        */
+        RLBWT(const std::string& bwt, size_t dollar);
+
+        // Returns the number of rows (the text length plus one, or 0 if empty)
+        size_t length() const;
+
+        // Returns the number of runs r
+        size_t runs() const;
+
+        // Returns r / n, the fraction of rows that start a run
+        double runRatio() const;
+
+        // Returns the row of the sentinel
+        size_t sentinel() const;
+
+        // Returns the character at row i (the sentinel row reads as '$'), or '\0' past the last row
+        char access(size_t i) const;
+
+        /**
+        * Returns the occurrences of c in rows [0, i), never counting the sentinel.
+        * Any i past the last row counts the whole BWT.
+        */
+        size_t rank(unsigned char c, size_t i) const;
+
+        /**
+        * Returns the row of occurrence j (from 0) of c, or std::string::npos if c occurs
+        * at most j times.
+        */
+        size_t select(unsigned char c, size_t j) const;
+
+        /**
+        * Returns the row of the suffix one position to the left of row i's suffix
+        * (0 for the sentinel row, std::string::npos past the last row).
+        */
+        size_t LF(size_t i) const;
+
+        // Returns the original text by walking LF from row 0
+        std::string decode() const;
+
+        // Returns the bytes held by the structure
+        size_t bytes() const;
+
+    private:
+        std::string heads;
+        std::vector<size_t> starts;
+        std::vector<size_t> before;
+
+        // The runs of each character, in row order
+        std::vector<size_t> byChar[256];
+
+        // blockRun[b]: the run holding row b << shift
+        std::vector<size_t> blockRun;
+        unsigned shift = 0;
+
+        size_t C[256] = {0};
+        size_t dollar = 0;
+        size_t dollarRun = 0;
+
+        // Returns the run holding row i, for i < length()
+        size_t runOf(size_t i) const;
+
+        void build(const std::string& bwt);
+};
@@ -0,0 +1,170 @@
+/**
+ * @file sais.h
+ * Linear-time suffix array construction by induced sorting (SA-IS, Nong, Zhang & Chan 2009).
+ *
+ * The input is any random-access sequence s[0..n) whose last symbol s[n-1] is a
+ * unique sentinel smaller than every other symbol, with all symbols in [0, K].
+ * Besides SA itself only a bit per symbol and one bucket array of K + 1 entries
+ * are allocated per level; the reduced problem is stored inside SA and solved recursively.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+namespace sais_detail {
+
+  // Fills bkt with the start (or end) of every symbol's bucket
+  template <typename Index, typename Text>
+  void getBuckets(const Text& s, std::vector<Index>& bkt, Index n, Index K, bool end) {
+    std::fill(bkt.begin(), bkt.end(), 0);
+    for (Index i{0}; i < n; ++i)
+      bkt[s[i]]++;
+
+    Index sum = 0;
+    for (Index c{0}; c <= K; ++c) {
+      sum += bkt[c];
+      bkt[c] = end ? sum : sum - bkt[c];
+    }
+  }
+
+  // Induces L-type suffixes left to right from the sorted seeds in SA
+  template <typename Index, typename Text>
+  void induceL(const std::vector<bool>& t, Index* SA, const Text& s, std::vector<Index>& bkt, Index n, Index K) {
+    getBuckets(s, bkt, n, K, false);
+    for (Index i{0}; i < n; ++i) {
+      Index j = SA[i] - 1;
+      if (SA[i] > 0 && !t[j])
+        SA[bkt[s[j]]++] = j;
+    }
+  }
+
+  // Induces S-type suffixes right to left from the L-type suffixes in SA
+  template <typename Index, typename Text>
+  void induceS(const std::vector<bool>& t, Index* SA, const Text& s, std::vector<Index>& bkt, Index n, Index K) {
+    getBuckets(s, bkt, n, K, true);
+    for (Index i{n - 1}; i >= 0; --i) {
+      Index j = SA[i] - 1;
+      if (SA[i] > 0 && t[j])
+        SA[--bkt[s[j]]] = j;
+    }
+  }
+
+}
+
+/**
+ * Writes the suffix array of s[0..n) into SA[0..n).
+ *
+ * @param s The text; s[n - 1] must be a unique smallest sentinel
+ * @param SA Output array of n entries
+ * @param n The text length, including the sentinel
+ * @param K The largest symbol value in s
+ */
+template <typename Index, typename Text>
+void sais(const Text& s, Index* SA, Index n, Index K) {
+  using namespace sais_detail;
+
+  if (n == 1) {
+    SA[0] = 0;
+    return;
+  }
+
+  // Classify suffixes: t[i] is true for S-type (s[i..] < s[i+1..])
+  std::vector<bool> t(n, false);
+  t[n - 1] = true;
+  for (Index i{n - 2}; i >= 0; --i)
+    t[i] = s[i] < s[i + 1] || (s[i] == s[i + 1] && t[i + 1]);
+
+  auto isLMS = [&t](Index i) { return i > 0 && t[i] && !t[i - 1]; };
+
+  // Stage 1: sort LMS substrings by induced sorting from their bucket ends
+  std::vector<Index> bkt(K + 1);
+  getBuckets(s, bkt, n, K, true);
+  for (Index i{0}; i < n; ++i)
+    SA[i] = -1;
+  for (Index i{1}; i < n; ++i) {
+    if (isLMS(i))
+      SA[--bkt[s[i]]] = i;
+  }
+  induceL(t, SA, s, bkt, n, K);
+  induceS(t, SA, s, bkt, n, K);
+
+  // Compact the sorted LMS substrings into SA[0..n1)
+  Index n1 = 0;
+  for (Index i{0}; i < n; ++i) {
+    if (isLMS(SA[i]))
+      SA[n1++] = SA[i];
+  }
+
+  // Name LMS substrings; equal substrings share a name
+  for (Index i{n1}; i < n; ++i)
+    SA[i] = -1;
+  Index name = 0;
+  Index prev = -1;
+  for (Index i{0}; i < n1; ++i) {
+    Index pos = SA[i];
+    bool diff = false;
+    for (Index d{0}; d < n; ++d) {
+      if (prev == -1 || s[pos + d] != s[prev + d] || t[pos + d] != t[prev + d]) {
+        diff = true;
+        break;
+      } else if (d > 0 && (isLMS(pos + d) || isLMS(prev + d))) {
+        break;
+      }
+    }
+    if (diff) {
+      name++;
+      prev = pos;
+    }
+    // LMS positions are never adjacent, so pos / 2 is a unique slot
+    SA[n1 + pos / 2] = name - 1;
+  }
+  for (Index i{n - 1}, j{n - 1}; i >= n1; --i) {
+    if (SA[i] >= 0)
+      SA[j--] = SA[i];
+  }
+
+  // Stage 2: sort the reduced string, recursing only if names repeat
+  Index* SA1 = SA;
+  Index* s1 = SA + n - n1;
+  if (name < n1) {
+    sais<Index, const Index*>(s1, SA1, n1, name - 1);
+  } else {
+    for (Index i{0}; i < n1; ++i)
+      SA1[s1[i]] = i;
+  }
+
+  // Stage 3: place the sorted LMS suffixes and induce the rest
+  getBuckets(s, bkt, n, K, true);
+  for (Index i{1}, j{0}; i < n; ++i) {
+    if (isLMS(i))
+      s1[j++] = i;
+  }
+  for (Index i{0}; i < n1; ++i)
+    SA1[i] = s1[SA1[i]];
+  for (Index i{n1}; i < n; ++i)
+    SA[i] = -1;
+  for (Index i{n1 - 1}; i >= 0; --i) {
+    Index j = SA[i];
+    SA[i] = -1;
+    SA[--bkt[s[j]]] = j;
+  }
+  induceL(t, SA, s, bkt, n, K);
+  induceS(t, SA, s, bkt, n, K);
+}
+
+/**
+ * A byte string viewed with a virtual sentinel: symbol i is byte i + 1,
+ * and position |T| holds the unique smallest symbol 0. K is 256.
+ */
+template <typename Index>
+struct SentinelText
+{
+  const unsigned char* p;
+  Index n;
+
+  Index operator[](Index i) const {
+    return i < n ? static_cast<Index>(p[i]) + 1 : 0;
+  }
+};
@@ -3,8 +3,18 @@
 #include <string>
 #include <iostream>
 #include <vector>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
 
 #include "bwt.h"
+#include "bwz.h"
+#include "bwt_external.h"
+#include "bwt_store.h"
+#include "rlbwt.h"
+#include "bwt_collection.h"
+#include "dynamic_bwt.h"
 
 /*
 * Helper functions for basic tests
@@ -121,4 +131,644 @@ TEST_CASE("decode_BWT Public Test 5 (Upper and Lower Case)", "[weight=5]") {
   std::string T = decode_bwt(bwt);
 
   matchString(T,ans);
-}
\ No newline at end of file
+}
+
+/*
+* Linear-time encode_bwt test cases
+*/
+
+// Reference BWT from plainly sorted suffixes ('$' smallest)
+std::string referenceBWT(std::string T){
+  std::vector<size_t> sa;
+  for(size_t i = 0; i <= T.size(); ++i){
+    sa.push_back(i);
+  }
+  std::sort(sa.begin(), sa.end(), [&T](size_t a, size_t b){
+    return T.compare(a, std::string::npos, T, b, std::string::npos) < 0;
+  });
+
+  std::string bwt;
+  for(size_t i : sa){
+    bwt += i == 0 ? '$' : T[i - 1];
+  }
+  return bwt;
+}
+
+std::string randomText(size_t n, int sigma, unsigned seed){
+  std::string T;
+  for(size_t i = 0; i < n; ++i){
+    seed = seed * 1103515245 + 12345;
+    T += static_cast<char>('A' + (seed >> 16) % sigma);
+  }
+  return T;
+}
+
+TEST_CASE("Encode_BWT handles tiny and repetitive texts", "[weight=0]") {
+  matchString(encode_bwt(""), "$");
+  matchString(encode_bwt("A"), "A$");
+  matchString(encode_bwt("AAAAAAAA"), referenceBWT("AAAAAAAA"));
+  matchString(encode_bwt("ABABABABABABA"), referenceBWT("ABABABABABABA"));
+  matchString(encode_bwt("mississippi"), "ipssm$pissii");
+}
+
+TEST_CASE("Encode_BWT matches sorted suffixes on random texts", "[weight=0]") {
+  for(int sigma : {1, 2, 4, 26}){
+    for(size_t n : {10, 100, 1000}){
+      std::string T = randomText(n, sigma, n + sigma);
+      INFO("sigma = " + std::to_string(sigma) + ", n = " + std::to_string(n));
+      matchString(encode_bwt(T), referenceBWT(T));
+    }
+  }
+}
+
+TEST_CASE("Encode_BWT handles arbitrary bytes", "[weight=0]") {
+  std::string T;
+  for(int i = 0; i < 600; ++i){
+    T += static_cast<char>((i * 37) % 256);
+  }
+  T += std::string("\0\0\xff\xff", 4);
+
+  matchString(encode_bwt(T), referenceBWT(T));
+}
+
+
+/*
+* Linear-time decode_bwt test cases
+*/
+
+TEST_CASE("Decode_BWT inverts encode_bwt on random texts", "[weight=0]") {
+  for(int sigma : {1, 2, 4, 26}){
+    for(size_t n : {1, 10, 1000, 100000}){
+      std::string T = randomText(n, sigma, n * sigma);
+      INFO("sigma = " + std::to_string(sigma) + ", n = " + std::to_string(n));
+      REQUIRE(decode_bwt(encode_bwt(T)) == T);
+    }
+  }
+}
+
+TEST_CASE("Decode_BWT handles binary input", "[weight=0]") {
+  std::string T;
+  for(int i = 0; i < 5000; ++i){
+    char c = static_cast<char>((i * 131 + i / 7) % 256);
+    T += c == '$' ? '\0' : c;
+  }
+
+  REQUIRE(decode_bwt(encode_bwt(T)) == T);
+}
+
+TEST_CASE("Decode_BWT rejects BWTs without exactly one sentinel", "[weight=0]") {
+  REQUIRE(decode_bwt("$") == "");
+  REQUIRE(decode_bwt("ABBA") == "");
+  REQUIRE(decode_bwt("A$B$") == "");
+}
+
+
+/*
+* BWT block compressor test cases
+*/
+
+TEST_CASE("Encode_BWT reports the sentinel row for texts containing '$'", "[weight=0]") {
+  std::string T = "a$b$$c$";
+  size_t dollar;
+  std::string bwt = encode_bwt(T, dollar);
+
+  REQUIRE(bwt.length() == T.length() + 1);
+  REQUIRE(decode_bwt(bwt, dollar) == T);
+  REQUIRE(decode_bwt(bwt, 0) == "");
+  REQUIRE(decode_bwt(bwt, bwt.length()) == "");
+}
+
+TEST_CASE("bwz round trips empty, tiny and repetitive inputs", "[weight=0]") {
+  for(std::string data : {std::string(""), std::string("x"), std::string(100000, 'a'), std::string("$$$$")}){
+    std::string restored = "stale";
+    REQUIRE(bwz_decompress(bwz_compress(data), restored));
+    REQUIRE(restored == data);
+  }
+}
+
+TEST_CASE("bwz round trips binary data across many blocks", "[weight=0]") {
+  std::string data;
+  for(int i = 0; i < 200000; ++i){
+    data += static_cast<char>(i % 7 == 0 ? (i * 2654435761u) >> 24 : i / 300);
+  }
+
+  for(unsigned long blockSize : {64UL, 1000UL, 65536UL, BWZ_BLOCK_SIZE}){
+    INFO("blockSize = " + std::to_string(blockSize));
+    std::string archive = bwz_compress(data, blockSize, 3);
+    std::string restored;
+    REQUIRE(bwz_decompress(archive, restored, 3));
+    REQUIRE(restored == data);
+  }
+}
+
+TEST_CASE("bwz output does not depend on the thread count", "[weight=0]") {
+  std::string data = randomText(300000, 4, 7);
+  std::string one = bwz_compress(data, 50000, 1);
+
+  REQUIRE(bwz_compress(data, 50000, 4) == one);
+  REQUIRE(one.length() < data.length() / 3);
+
+  std::string restored;
+  REQUIRE(bwz_decompress(one, restored, 1));
+  REQUIRE(restored == data);
+}
+
+TEST_CASE("bwz rejects truncated and corrupted archives", "[weight=0]") {
+  std::string data = randomText(50000, 26, 11);
+  std::string archive = bwz_compress(data, 20000);
+  std::string restored;
+
+  REQUIRE_FALSE(bwz_decompress("", restored));
+  REQUIRE_FALSE(bwz_decompress(archive.substr(0, archive.length() - 1), restored));
+  REQUIRE_FALSE(bwz_decompress("XWZ1" + archive.substr(4), restored));
+
+  for(size_t pos : {size_t(30), archive.length() / 2, archive.length() - 1}){
+    std::string corrupt = archive;
+    corrupt[pos] ^= 0x10;
+    REQUIRE_FALSE(bwz_decompress(corrupt, restored));
+  }
+}
+
+// Returns a bwz header claiming count blocks of blockSize bytes, each stored in blockBytes
+std::string forgeBWZ(uint32_t blockSize, uint32_t count, uint32_t blockBytes){
+  std::string archive = "BWZ1";
+  auto put = [&archive](uint64_t v, int bytes){
+    for(int i = 0; i < bytes; ++i){
+      archive += static_cast<char>(v >> (8 * i));
+    }
+  };
+  put(blockSize, 4);
+  put(static_cast<uint64_t>(blockSize) * count, 8);
+  put(count, 4);
+  for(uint32_t k = 0; k < count; ++k){
+    put(blockBytes, 4);
+  }
+  for(uint32_t k = 0; k < count; ++k){
+    put(1, 4);
+    archive += std::string(blockBytes - 4, '\xff');
+  }
+  return archive;
+}
+
+TEST_CASE("bwz rejects forged headers without allocating their claimed size", "[weight=0]") {
+  std::string restored = "unchanged";
+  // 4000 empty blocks of 64 MB would claim 250 GB
+  REQUIRE_FALSE(bwz_decompress(forgeBWZ(1 << 26, 4000, 4), restored));
+  REQUIRE_FALSE(bwz_decompress(forgeBWZ(1 << 26, 100, 8), restored));
+  // Plausibly sized blocks holding garbage fail to decode
+  REQUIRE_FALSE(bwz_decompress(forgeBWZ(1 << 26, 100, 200), restored));
+  REQUIRE(restored == "unchanged");
+}
+
+
+/*
+* External-memory BWT test cases
+*/
+
+// Writes T to path, builds its BWT with encode_bwt_external and checks it against encode_bwt
+void checkExternal(const std::string& T, unsigned long block){
+  const std::string path = "external_bwt_input.txt";
+  const std::string out = "external_bwt_output.txt";
+  std::ofstream(path, std::ios::binary) << T;
+
+  // Memory for the I/O buffers plus 9 bytes per block character
+  unsigned long limit = 3 * 65536 + 9 * block;
+  REQUIRE(external_bwt_block(limit) == block);
+  long dollar = encode_bwt_external(path, out, limit);
+
+  std::ifstream in(out, std::ios::binary);
+  std::stringstream bwt;
+  bwt << in.rdbuf();
+
+  size_t expectedDollar;
+  std::string expected = encode_bwt(T, expectedDollar);
+  INFO("n = " + std::to_string(T.length()) + ", block = " + std::to_string(block));
+  REQUIRE(dollar == static_cast<long>(expectedDollar));
+  matchString(bwt.str(), expected);
+
+  std::remove(path.c_str());
+  std::remove(out.c_str());
+}
+
+TEST_CASE("encode_bwt_external matches encode_bwt on random texts", "[weight=0]") {
+  for(int sigma : {1, 2, 4, 26}){
+    for(unsigned long block : {1UL, 3UL, 16UL, 100UL, 5000UL}){
+      checkExternal(randomText(1000, sigma, sigma + block), block);
+    }
+  }
+}
+
+TEST_CASE("encode_bwt_external handles repeats, binary data and tiny inputs", "[weight=0]") {
+  checkExternal("", 4);
+  checkExternal("a", 4);
+  checkExternal("banana", 2);
+
+  std::string periodic;
+  for(int i = 0; i < 3000; ++i){
+    periodic += "abaababa"[i % 8];
+  }
+  for(unsigned long block : {7UL, 64UL, 500UL}){
+    checkExternal(periodic, block);
+  }
+
+  std::string binary;
+  for(int i = 0; i < 4000; ++i){
+    binary += static_cast<char>(i % 13 == 0 ? '$' : (i * i) % 251);
+  }
+  checkExternal(binary, 300);
+}
+
+TEST_CASE("encode_bwt_external reports unreadable input", "[weight=0]") {
+  REQUIRE(encode_bwt_external("no/such/input.txt", "external_bwt_output.txt") == -1);
+}
+
+
+/*
+* BWTStore (sampled inverse suffix array) test cases
+*/
+
+TEST_CASE("BWTStore extracts every substring of a small text", "[weight=0]") {
+  std::string T = "This_is_a_simple_sample_text";
+  size_t dollar;
+  std::string bwt = encode_bwt(T, dollar);
+  for(unsigned long rate : {1UL, 3UL, 8UL, 100UL}){
+    BWTStore store(bwt, dollar, rate);
+    REQUIRE(store.length() == T.length());
+    for(size_t i = 0; i < T.length(); ++i){
+      for(size_t len = 0; i + len <= T.length(); ++len){
+        REQUIRE(store.extract(i, len) == T.substr(i, len));
+      }
+    }
+  }
+}
+
+TEST_CASE("BWTStore extracts from random and binary texts", "[weight=0]") {
+  for(int sigma : {1, 4, 26}){
+    std::string T = randomText(20000, sigma, 3 * sigma);
+    size_t dollar;
+    std::string bwt = encode_bwt(T, dollar);
+    BWTStore store(bwt, dollar, 64);
+    for(size_t i = 0; i < T.length(); i += 997){
+      REQUIRE(store.extract(i, 300) == T.substr(i, 300));
+    }
+  }
+
+  std::string binary;
+  for(int i = 0; i < 5000; ++i){
+    binary += static_cast<char>((i * 131 + i / 7) % 256);
+  }
+  size_t dollar;
+  std::string bwt = encode_bwt(binary, dollar);
+  BWTStore store(bwt, dollar, 16);
+  REQUIRE(store.extract(0, binary.length()) == binary);
+  REQUIRE(store.extract(1234, 55) == binary.substr(1234, 55));
+}
+
+TEST_CASE("BWTStore clamps reads past the end and rejects invalid BWTs", "[weight=0]") {
+  BWTStore store(encode_bwt("banana"));
+  REQUIRE(store.extract(4, 10) == "na");
+  REQUIRE(store.extract(6, 1) == "");
+  REQUIRE(store.extract(100, 1) == "");
+
+  REQUIRE(BWTStore("ABBA").length() == 0);
+  REQUIRE(BWTStore("A$B$").extract(0, 2) == "");
+  REQUIRE(BWTStore(encode_bwt("")).length() == 0);
+  REQUIRE(BWTStore("n$nbaaa", 0).length() == 0);
+  REQUIRE(BWTStore("annb$aa", 9).length() == 0);
+}
+
+TEST_CASE("BWTStore reads the sentinel's row from its second argument", "[weight=0]") {
+  // The text holds '$', so only the explicit row identifies the sentinel
+  std::string T = "ab$ab$ab";
+  size_t dollar;
+  std::string bwt = encode_bwt(T, dollar);
+  BWTStore store(bwt, dollar);
+  REQUIRE(store.length() == T.length());
+  REQUIRE(store.extract(0, T.length()) == T);
+  REQUIRE(BWTStore(bwt, dollar, 2).extract(2, 4) == "$ab$");
+}
+
+TEST_CASE("BWTStore samples shrink with the sample rate", "[weight=0]") {
+  size_t dollar;
+  std::string bwt = encode_bwt(randomText(100000, 4, 5), dollar);
+  REQUIRE(BWTStore(bwt, dollar, 4).bytes() > BWTStore(bwt, dollar, 64).bytes());
+  // The BWT itself, at most 2 bytes per character of occurrence samples and 8 / 64 of ISA samples
+  REQUIRE(BWTStore(bwt, dollar, 64).bytes() < 3 * bwt.length() + 4096);
+}
+
+
+/*
+* Parallel decode_bwt test cases
+*/
+
+TEST_CASE("decode_bwt_parallel inverts encode_bwt for any interval and thread count", "[weight=0]") {
+  std::string T = randomText(100000, 4, 17);
+  for(unsigned long interval : {1UL, 7UL, 1000UL, 65536UL, 1000000UL, ~0UL}){
+    for(unsigned threads : {1u, 3u}){
+      INFO("interval = " + std::to_string(interval) + ", threads = " + std::to_string(threads));
+      size_t dollar;
+      RestartPoints restarts;
+      std::string bwt = encode_bwt(T, dollar, restarts, interval);
+      REQUIRE(bwt == encode_bwt(T));
+      REQUIRE(restarts.rows.size() == T.length() / interval + (T.length() % interval != 0));
+      REQUIRE(decode_bwt_parallel(bwt, dollar, restarts, threads) == T);
+    }
+  }
+}
+
+TEST_CASE("decode_bwt_parallel handles binary and tiny texts", "[weight=0]") {
+  std::string binary;
+  for(int i = 0; i < 5000; ++i){
+    binary += static_cast<char>((i * 131 + i / 7) % 256);
+  }
+  for(std::string T : {binary, std::string("a"), std::string("$$")}){
+    size_t dollar;
+    RestartPoints restarts;
+    std::string bwt = encode_bwt(T, dollar, restarts, 3);
+    REQUIRE(decode_bwt_parallel(bwt, dollar, restarts, 2) == T);
+  }
+}
+
+TEST_CASE("decode_bwt_parallel falls back when the restart points do not match", "[weight=0]") {
+  std::string T = randomText(5000, 26, 3);
+  size_t dollar;
+  RestartPoints restarts;
+  std::string bwt = encode_bwt(T, dollar, restarts, 100);
+
+  RestartPoints wrongSize = restarts;
+  wrongSize.rows.pop_back();
+  REQUIRE(decode_bwt_parallel(bwt, dollar, wrongSize) == T);
+  REQUIRE(decode_bwt_parallel(bwt, dollar, RestartPoints()) == T);
+  REQUIRE(decode_bwt_parallel(bwt, 0, restarts) == "");
+}
+
+/*
+ * Run-length BWT
+ */
+
+// Returns copies of a random base text, each with a few point mutations
+std::string repetitiveText(size_t base, size_t copies, unsigned seed){
+  std::string B = randomText(base, 4, seed);
+  std::string T;
+  for(size_t k = 0; k < copies; ++k){
+    std::string copy = B;
+    copy[(k * 7919 + seed) % base] = 'x';
+    T += copy;
+  }
+  return T;
+}
+
+TEST_CASE("RLBWT answers access, rank, select and LF like the plain BWT", "[weight=0]") {
+  for(std::string T : {randomText(3000, 3, 1), repetitiveText(500, 8, 2), std::string("aaaaab"), std::string("a$b$")}){
+    size_t dollar;
+    std::string bwt = encode_bwt(T, dollar);
+    RLBWT rl(bwt, dollar);
+    REQUIRE(rl.length() == bwt.length());
+    REQUIRE(rl.sentinel() == dollar);
+
+    size_t runs = 0;
+    for(size_t i = 0; i < bwt.length(); ++i){
+      runs += i == 0 || i == dollar || i == dollar + 1 || bwt[i] != bwt[i - 1];
+    }
+    REQUIRE(rl.runs() == runs);
+
+    std::vector<size_t> count(256, 0), C(256, 1);
+    for(size_t i = 0; i < bwt.length(); ++i){
+      if(i != dollar){
+        count[static_cast<unsigned char>(bwt[i])]++;
+      }
+    }
+    for(int c = 1; c < 256; ++c){
+      C[c] = C[c - 1] + count[c - 1];
+    }
+
+    std::vector<size_t> seen(256, 0);
+    for(size_t i = 0; i < bwt.length(); ++i){
+      unsigned char c = bwt[i];
+      REQUIRE(rl.access(i) == bwt[i]);
+      for(unsigned char q : {'$', 'a', 'b', 'c', 'x'}){
+        REQUIRE(rl.rank(q, i) == seen[q]);
+      }
+      if(i == dollar){
+        REQUIRE(rl.LF(i) == 0);
+        continue;
+      }
+      REQUIRE(rl.select(c, seen[c]) == i);
+      REQUIRE(rl.LF(i) == C[c] + seen[c]);
+      seen[c]++;
+    }
+    for(unsigned char q : {'$', 'a', 'b', 'x'}){
+      REQUIRE(rl.rank(q, bwt.length()) == seen[q]);
+      REQUIRE(rl.select(q, seen[q]) == std::string::npos);
+    }
+    REQUIRE(rl.decode() == T);
+  }
+}
+
+TEST_CASE("RLBWT takes memory in proportion to the runs", "[weight=0]") {
+  std::string T = repetitiveText(1000, 400, 9);
+  std::string bwt = encode_bwt(T);
+  RLBWT rl(bwt);
+  REQUIRE(rl.runRatio() < 0.1);
+  REQUIRE(rl.bytes() < 40 * rl.runs() + 16384);
+  REQUIRE(rl.bytes() < bwt.length() / 3);
+  REQUIRE(rl.decode() == T);
+}
+
+TEST_CASE("RLBWT rejects invalid BWTs", "[weight=0]") {
+  REQUIRE(RLBWT("abc").length() == 0);
+  REQUIRE(RLBWT("a$b$").length() == 0);
+  REQUIRE(RLBWT("abc", 3).length() == 0);
+  REQUIRE(RLBWT("abc").decode() == "");
+  REQUIRE(RLBWT("abc").runRatio() == 0);
+  REQUIRE(RLBWT("$ab").length() == 0);
+  REQUIRE(RLBWT("cab", 0).length() == 0);
+  REQUIRE(RLBWT("$", 0).decode() == "");
+
+  RLBWT empty("abc");
+  REQUIRE(empty.access(0) == '\0');
+  REQUIRE(empty.LF(0) == std::string::npos);
+  REQUIRE(empty.rank('a', 5) == 0);
+  REQUIRE(empty.select('a', 0) == std::string::npos);
+
+  RLBWT rl(encode_bwt("banana"));
+  REQUIRE(rl.access(rl.length()) == '\0');
+  REQUIRE(rl.LF(rl.length()) == std::string::npos);
+}
+
+
+/*
+* Collection (BCR) BWT test cases
+*/
+
+// The collection BWT by sorting every suffix of every read; ties between equal suffixes go to the lower read
+std::string referenceCollectionBWT(const std::vector<std::string>& reads, std::vector<size_t>& ids){
+  std::vector<std::pair<size_t, size_t>> suffixes;
+  for(size_t i = 0; i < reads.size(); ++i){
+    for(size_t k = 0; k <= reads[i].length(); ++k){
+      suffixes.push_back({i, k});
+    }
+  }
+  std::sort(suffixes.begin(), suffixes.end(), [&reads](const std::pair<size_t, size_t>& a, const std::pair<size_t, size_t>& b){
+    int c = reads[a.first].compare(a.second, std::string::npos, reads[b.first], b.second, std::string::npos);
+    return c != 0 ? c < 0 : a.first < b.first;
+  });
+
+  std::string bwt;
+  ids.clear();
+  for(auto& s : suffixes){
+    if(s.second == 0){
+      bwt += '$';
+      ids.push_back(s.first);
+    } else {
+      bwt += reads[s.first][s.second - 1];
+    }
+  }
+  return bwt;
+}
+
+void checkCollection(const std::vector<std::string>& reads){
+  const std::string path = "collection_bwt_reads.txt";
+  const std::string out = "collection_bwt_output.txt";
+  {
+    std::ofstream file(path, std::ios::binary);
+    for(const std::string& r : reads){
+      file << r << '\n';
+    }
+  }
+
+  std::vector<size_t> ids;
+  REQUIRE(encode_bwt_collection(path, out, ids) == static_cast<long>(reads.size()));
+
+  std::ifstream in(out, std::ios::binary);
+  std::stringstream bwt;
+  bwt << in.rdbuf();
+  in.close();
+
+  std::vector<size_t> expectedIds;
+  matchString(bwt.str(), referenceCollectionBWT(reads, expectedIds));
+  REQUIRE(ids == expectedIds);
+
+  std::remove(path.c_str());
+  std::remove(out.c_str());
+}
+
+TEST_CASE("encode_bwt_collection matches sorted suffixes of the reads", "[weight=0]") {
+  checkCollection({"banana"});
+  checkCollection({"ACGT", "ACGT", "ACGT"});
+  checkCollection({"A", "AA", "AAA", "A"});
+  checkCollection({"TTAG", "CAT", "G", "GATTACA", "TAG"});
+
+  for(int sigma : {2, 4}){
+    std::vector<std::string> reads;
+    for(unsigned k = 0; k < 200; ++k){
+      std::string r = randomText(1 + k % 23, sigma, k * 31 + sigma);
+      reads.push_back(k % 5 == 0 && k > 0 ? reads[k - 1] : r);
+    }
+    checkCollection(reads);
+  }
+}
+
+TEST_CASE("encode_bwt_collection of one read is encode_bwt", "[weight=0]") {
+  std::string T = randomText(500, 4, 8);
+  std::ofstream("collection_bwt_reads.txt", std::ios::binary) << T << "\n\n";
+  std::vector<size_t> ids;
+  REQUIRE(encode_bwt_collection("collection_bwt_reads.txt", "collection_bwt_output.txt", ids) == 1);
+
+  std::ifstream in("collection_bwt_output.txt", std::ios::binary);
+  std::stringstream bwt;
+  bwt << in.rdbuf();
+  matchString(bwt.str(), encode_bwt(T));
+  REQUIRE(ids == std::vector<size_t>{0});
+
+  std::remove("collection_bwt_reads.txt");
+  std::remove("collection_bwt_output.txt");
+}
+
+TEST_CASE("encode_bwt_collection rejects missing files and reads holding '$'", "[weight=0]") {
+  std::vector<size_t> ids;
+  REQUIRE(encode_bwt_collection("no_such_reads.txt", "collection_bwt_output.txt", ids) == -1);
+
+  std::ofstream("collection_bwt_reads.txt", std::ios::binary) << "ACGT\nAC$T\n";
+  REQUIRE(encode_bwt_collection("collection_bwt_reads.txt", "collection_bwt_output.txt", ids) == -1);
+  std::remove("collection_bwt_reads.txt");
+  std::remove("collection_bwt_output.txt");
+}
+
+
+/*
+* Dynamic BWT test cases
+*/
+
+TEST_CASE("DynamicSequence matches a string under random inserts and updates", "[weight=0]") {
+  for(size_t leaf : {2UL, 7UL, 64UL}){
+    DynamicSequence seq(leaf, 3);
+    std::string s;
+    unsigned seed = 5;
+    for(int step = 0; step < 3000; ++step){
+      seed = seed * 1103515245 + 12345;
+      char c = "abcd"[(seed >> 16) % 4];
+      size_t i = (seed >> 8) % (s.length() + 1);
+      if(step % 5 == 4 && !s.empty()){
+        seq.set(i % s.length(), c);
+        s[i % s.length()] = c;
+      } else {
+        seq.insert(i, c);
+        s.insert(s.begin() + i, c);
+      }
+    }
+
+    INFO("leaf = " + std::to_string(leaf));
+    REQUIRE(seq.length() == s.length());
+    REQUIRE(seq.str() == s);
+    for(size_t i = 0; i <= s.length(); i += 37){
+      if(i < s.length()){
+        REQUIRE(seq.at(i) == s[i]);
+      }
+      for(char c : {'a', 'd', 'z'}){
+        REQUIRE(seq.rank(c, i) == static_cast<size_t>(std::count(s.begin(), s.begin() + i, c)));
+      }
+    }
+  }
+}
+
+TEST_CASE("DynamicBWT keeps the BWT of the reversed text while appending", "[weight=0]") {
+  for(size_t leaf : {4UL, 100UL, DYNAMIC_LEAF_BYTES}){
+    std::string T = randomText(3000, 3, 21) + "$A$" + randomText(1000, 26, 4);
+    DynamicBWT dyn(T.substr(0, 10), leaf);
+    for(size_t k = 10; k < T.length(); k += 333){
+      dyn.append(T.substr(k, 333));
+    }
+
+    INFO("leaf = " + std::to_string(leaf));
+    std::string R(T.rbegin(), T.rend());
+    size_t expectedDollar;
+    std::string expected = encode_bwt(R, expectedDollar);
+    size_t dollar;
+    matchString(dyn.bwt(dollar), expected);
+    REQUIRE(dollar == expectedDollar);
+    REQUIRE(dyn.length() == T.length());
+    REQUIRE(dyn.text() == T);
+  }
+}
+
+TEST_CASE("DynamicBWT counts patterns as the text grows", "[weight=0]") {
+  DynamicBWT dyn;
+  REQUIRE(dyn.count("A") == 0);
+  REQUIRE(dyn.text() == "");
+
+  std::string T;
+  for(unsigned day = 0; day < 5; ++day){
+    std::string chunk = randomText(400, 2, day + 1);
+    dyn.append(chunk);
+    T += chunk;
+    for(std::string P : std::vector<std::string>{"A", "AB", "BBA", "ABABA", T.substr(100, 12), "C"}){
+      size_t expected = 0;
+      for(size_t i = 0; i + P.length() <= T.length(); ++i){
+        expected += T.compare(i, P.length(), P) == 0;
+      }
+      REQUIRE(dyn.count(P) == expected);
+    }
+  }
+  REQUIRE(dyn.count("") == 0);
+}
@@ -0,0 +1,86 @@
+/**
+ * @file bench.cpp
+ * Throughput benchmark of every exact matcher across text sizes, pattern lengths and alphabets.
+ *
+ * Usage: ./bench [MAX_TEXT_SIZE]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "matcher.h"
+#include "workload.h"
+
+// zval rescans from scratch at every position, so it only runs on small texts
+static const long ZVAL_MAX_TEXT = 1 << 14;
+
+// Minimum measured time per configuration
+static const double MIN_SECONDS = 0.2;
+
+/**
+ * Returns the average seconds per find_all call, repeating until MIN_SECONDS have passed.
+ */
+double time_matcher(Matcher& matcher, const std::string& T, long& matches) {
+  using clock = std::chrono::steady_clock;
+
+  long runs = 0;
+  double elapsed = 0;
+  auto start = clock::now();
+  do {
+    matches = matcher.find_all(T, [](long) {});
+    runs++;
+    elapsed = std::chrono::duration<double>(clock::now() - start).count();
+  } while (elapsed < MIN_SECONDS);
+
+  return elapsed / runs;
+}
+
+int main(int argc, char** argv) {
+  long maxText = argc > 1 ? std::atol(argv[1]) : 1 << 20;
+
+  std::vector<long> sizes = {1 << 12, 1 << 16, 1 << 20, 1 << 24};
+  std::vector<long> lengths = {4, 16, 64};
+  auto matchers = make_matchers();
+
+  std::cout << std::left << std::setw(12) << "alphabet" << std::setw(10) << "n" << std::setw(6) << "m"
+            << std::setw(8) << "engine" << std::setw(10) << "matches" << "GB/s" << std::endl;
+
+  for (Alphabet a : all_alphabets()) {
+    for (long n : sizes) {
+      if (n > maxText)
+        continue;
+      std::string T = make_text(a, n);
+
+      for (long m : lengths) {
+        std::string P = make_pattern(a, T, m);
+        long expected = -1;
+
+        for (auto& matcher : matchers) {
+          if (matcher->name() == "zval" && n > ZVAL_MAX_TEXT)
+            continue;
+
+          matcher->prepare(P);
+          long matches = 0;
+          double seconds = time_matcher(*matcher, T, matches);
+
+          std::cout << std::setw(12) << alphabet_name(a) << std::setw(10) << n << std::setw(6) << m
+                    << std::setw(8) << matcher->name() << std::setw(10) << matches
+                    << std::fixed << std::setprecision(4) << n / seconds / 1e9;
+
+          // Every engine must agree with the first one
+          if (expected == -1)
+            expected = matches;
+          else if (matches != expected)
+            std::cout << "  MISMATCH (expected " << expected << ")";
+          std::cout << std::endl;
+        }
+      }
+    }
+  }
+
+  return 0;
+}
\ No newline at end of file
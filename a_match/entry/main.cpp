@@ -0,0 +1,27 @@
+/**
+ * @file main.cpp
+ * A simple C++ program running every exact matcher through the common interface.
+ */
+
+#include <string>
+#include <iostream>
+#include <vector>
+
+#include "matcher.h"
+
+int main() {
+  std::cout << "example 1" << std::endl;
+
+  std::string P = "pattern";
+  std::string T = "this is a pattern that has a repeat pattern";
+
+  for (auto& matcher : make_matchers()) {
+    matcher->prepare(P);
+
+    std::cout << matcher->name() << ": {";
+    matcher->find_all(T, [](long i) { std::cout << i << ", "; });
+    std::cout << "}" << std::endl;
+  }
+
+  return 0;
+}
\ No newline at end of file
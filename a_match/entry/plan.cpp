@@ -0,0 +1,61 @@
+/**
+ * @file plan.cpp
+ * Searches a text file through the query planner and explains its choice.
+ *
+ * Usage: ./plan PATTERN TEXT_FILE [--index] [--calibrate] [--quiet]
+ */
+
+#include <string>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include "planner.h"
+#include "sarray.h"
+
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    std::cout << "Usage: " << argv[0] << " PATTERN TEXT_FILE [--index] [--calibrate] [--quiet]" << std::endl;
+    return 1;
+  }
+
+  bool index = false;
+  bool recalibrate = false;
+  bool quiet = false;
+  for (int i{3}; i < argc; ++i) {
+    std::string flag = argv[i];
+    index |= flag == "--index";
+    recalibrate |= flag == "--calibrate";
+    quiet |= flag == "--quiet";
+  }
+
+  std::ifstream file(argv[2], std::ios::binary);
+  if (!file) {
+    std::cout << "Could not open " << argv[2] << std::endl;
+    return 1;
+  }
+  std::stringstream buffer;
+  buffer << file.rdbuf();
+  std::string T = buffer.str();
+  std::string P = argv[1];
+
+  Planner planner;
+  if (!quiet)
+    planner.setTrace(&std::cerr);
+  if (recalibrate || !planner.calibrated())
+    planner.calibrate();
+
+  std::vector<int> sa;
+  if (index)
+    sa = build_sarray(T);
+
+  std::vector<long> matches = planner.find_all(P, T, index ? &sa : nullptr);
+
+  std::cout << "{";
+  for (long i : matches)
+    std::cout << i << ", ";
+  std::cout << "}" << std::endl;
+
+  return 0;
+}
\ No newline at end of file
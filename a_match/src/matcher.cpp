@@ -0,0 +1,209 @@
+/**
+ * @file matcher.cpp
+ * Adapters from each assignment's search function to the Matcher interface.
+ */
+
+#include <algorithm>
+
+#include "matcher.h"
+#include "naive.h"
+#include "bmoore.h"
+#include "zval.h"
+#include "zalg.h"
+#include "zseq.h"
+#include "sarray.h"
+
+// naive_search copies its text, so it is only ever handed windows of this size
+static const long NAIVE_WINDOW = 1 << 16;
+
+/**
+ * Reports the matches of the sentinel-free zalg_search_seq. zval_search and zalg_search
+ * search P + '$' + T, so a '$' in T lets Z-values run past m and loses those matches;
+ * texts holding '$' are searched this way instead.
+ */
+static long find_all_seq(const std::string& P, const std::string& T, const MatchSink& sink) {
+  std::vector<long> outList = zalg_search_seq<long>(P, T);
+  for (long i : outList)
+    sink(i);
+  return outList.size();
+}
+
+std::string NaiveMatcher::name() const {
+  return "naive";
+}
+
+void NaiveMatcher::prepare(const std::string& P) {
+  this->P = P;
+}
+
+long NaiveMatcher::find_all(const std::string& T, const MatchSink& sink) {
+  long m = P.length();
+  long n = T.length();
+  long count = 0;
+
+  // Search window by window; windows overlap by m - 1 so no match is lost
+  long pos = 0;
+  while (pos + m <= n) {
+    long len = std::min(NAIVE_WINDOW + m - 1, n - pos);
+    int found = naive_search(P, T.substr(pos, len));
+    if (found == -1) {
+      pos += len - m + 1;
+      continue;
+    }
+
+    sink(pos + found);
+    count++;
+    pos += found + 1;
+  }
+
+  return count;
+}
+
+std::string BmooreMatcher::name() const {
+  return "bmoore";
+}
+
+void BmooreMatcher::prepare(const std::string& P) {
+  this->P = P;
+}
+
+long BmooreMatcher::find_all(const std::string& T, const MatchSink& sink) {
+  // bmoore_search needs every character of T in its alphabet
+  bool seen[256] = {false};
+  for (unsigned char c : P)
+    seen[c] = true;
+  for (unsigned char c : T)
+    seen[c] = true;
+
+  std::string alpha;
+  for (int c{0}; c < 256; ++c) {
+    if (seen[c])
+      alpha += static_cast<char>(c);
+  }
+
+  std::vector<int> outList;
+  bmoore_search(P, T, alpha, outList);
+
+  long count = 0;
+  for (int i : outList) {
+    if (i == -1)
+      continue;
+    sink(i);
+    count++;
+  }
+
+  return count;
+}
+
+std::string ZvalMatcher::name() const {
+  return "zval";
+}
+
+void ZvalMatcher::prepare(const std::string& P) {
+  this->P = P;
+}
+
+long ZvalMatcher::find_all(const std::string& T, const MatchSink& sink) {
+  if (T.find('$') != std::string::npos)
+    return find_all_seq(P, T, sink);
+
+  std::vector<int> outList = zval_search(P, T);
+
+  long count = 0;
+  for (int i : outList) {
+    if (i == -1)
+      continue;
+    sink(i);
+    count++;
+  }
+
+  return count;
+}
+
+std::string ZalgMatcher::name() const {
+  return "zalg";
+}
+
+void ZalgMatcher::prepare(const std::string& P) {
+  this->P = P;
+}
+
+long ZalgMatcher::find_all(const std::string& T, const MatchSink& sink) {
+  if (T.find('$') != std::string::npos)
+    return find_all_seq(P, T, sink);
+
+  std::vector<int> outList = zalg_search(P, T);
+
+  long count = 0;
+  for (int i : outList) {
+    if (i == -1)
+      continue;
+    sink(i);
+    count++;
+  }
+
+  return count;
+}
+
+std::string SarrayMatcher::name() const {
+  return "sarray";
+}
+
+void SarrayMatcher::prepare(const std::string& P) {
+  this->P = P;
+}
+
+void SarrayMatcher::setIndex(const std::vector<int>* sa) {
+  this->sa = sa;
+}
+
+long SarrayMatcher::find_all(const std::string& T, const MatchSink& sink) {
+  // Fall back to building a suffix array if none was given for this text
+  const std::vector<int>* index = sa;
+  std::vector<int> built;
+  if (!index || index->size() != T.length() + 1) {
+    built = build_sarray(T);
+    index = &built;
+  }
+
+  std::vector<int> outList = sarray_search(P, T, *index);
+
+  // Suffix array order is lexicographic; report in text order
+  std::sort(outList.begin(), outList.end());
+
+  long count = 0;
+  for (int i : outList) {
+    if (i == -1)
+      continue;
+    sink(i);
+    count++;
+  }
+
+  return count;
+}
+
+/**
+ * Returns one instance of every online exact matching engine (those needing no index).
+ */
+std::vector<std::unique_ptr<Matcher>> make_matchers() {
+  std::vector<std::unique_ptr<Matcher>> out;
+  out.emplace_back(new NaiveMatcher());
+  out.emplace_back(new BmooreMatcher());
+  out.emplace_back(new ZvalMatcher());
+  out.emplace_back(new ZalgMatcher());
+  return out;
+}
+
+/**
+ * Returns all match positions of the matcher's prepared pattern in T.
+ *
+ * @param matcher A prepared Matcher
+ * @param T The text string
+ *
+ * @return An std::vector<long> of match positions (empty if there is no match)
+ */
+std::vector<long> find_all(Matcher& matcher, const std::string& T) {
+  std::vector<long> out;
+  matcher.find_all(T, [&out](long i) { out.push_back(i); });
+  return out;
+}
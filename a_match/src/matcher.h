@@ -0,0 +1,107 @@
+/**
+ * @file matcher.h
+ * A common interface over the exact pattern matching engines of each assignment.
+ */
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Receives the index position (in T) of every exact match, in increasing order
+typedef std::function<void(long)> MatchSink;
+
+/**
+ * An exact pattern matcher: prepare once for a pattern, then search any number of texts.
+ * Unlike the underlying assignment functions, no sentinel value is ever reported;
+ * a text without matches simply never calls the sink.
+ */
+class Matcher
+{
+    public:
+        virtual ~Matcher() {}
+
+        /**
+        * Returns a short name for the engine (e.g. "bmoore")
+        */
+        virtual std::string name() const = 0;
+
+        /**
+        * Preprocesses the pattern used by every later find_all.
+        *
+        * @param P The pattern string (must be non-empty and free of '$')
+        */
+        virtual void prepare(const std::string& P) = 0;
+
+        /**
+        * Reports every exact match of the prepared pattern in T to sink.
+        *
+        * @param T The text string
+        * @param sink Called once per match position
+        *
+        * @return The number of matches found
+        */
+        virtual long find_all(const std::string& T, const MatchSink& sink) = 0;
+
+    protected:
+        std::string P;
+};
+
+// Wraps naive_search (first match only) by restarting after every match
+class NaiveMatcher : public Matcher
+{
+    public:
+        std::string name() const;
+        void prepare(const std::string& P);
+        long find_all(const std::string& T, const MatchSink& sink);
+};
+
+// Wraps bmoore_search; the alphabet is taken from the pattern and text
+class BmooreMatcher : public Matcher
+{
+    public:
+        std::string name() const;
+        void prepare(const std::string& P);
+        long find_all(const std::string& T, const MatchSink& sink);
+};
+
+// Wraps zval_search (Z-values by explicit scanning); texts holding '$' use zalg_search_seq
+class ZvalMatcher : public Matcher
+{
+    public:
+        std::string name() const;
+        void prepare(const std::string& P);
+        long find_all(const std::string& T, const MatchSink& sink);
+};
+
+// Wraps zalg_search (linear-time Z-algorithm); texts holding '$' use zalg_search_seq
+class ZalgMatcher : public Matcher
+{
+    public:
+        std::string name() const;
+        void prepare(const std::string& P);
+        long find_all(const std::string& T, const MatchSink& sink);
+};
+
+// Wraps sarray_search over a suffix array built ahead of time for one text
+class SarrayMatcher : public Matcher
+{
+    public:
+        std::string name() const;
+        void prepare(const std::string& P);
+        long find_all(const std::string& T, const MatchSink& sink);
+
+        /**
+        * Uses sa (built by build_sarray for the text later passed to find_all)
+        * instead of building a suffix array on every call. The caller keeps sa alive.
+        */
+        void setIndex(const std::vector<int>* sa);
+
+    private:
+        const std::vector<int>* sa = nullptr;
+};
+
+std::vector<std::unique_ptr<Matcher>> make_matchers();
+std::vector<long> find_all(Matcher& matcher, const std::string& T);
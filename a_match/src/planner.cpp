@@ -0,0 +1,242 @@
+/**
+ * @file planner.cpp
+ * Code to calibrate, persist and apply the exact matching query planner.
+ *
+ * Queries are classified by alphabet size (small / medium / large) and
+ * pattern length (short / medium / long). For every engine and class the
+ * calibration times find_all at two text sizes on a matching synthetic
+ * workload; a query's cost is then extrapolated to its real text size.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+#include "planner.h"
+#include "workload.h"
+#include "sarray.h"
+
+// First line of every profile file; bump when the format changes
+static const std::string PROFILE_HEADER = "matcher-profile 1";
+
+// Classes: alphabet size <= 4, <= 64, larger; pattern length <= 8, <= 32, longer
+static const int ALPHABET_CLASSES = 3;
+static const int LENGTH_CLASSES = 3;
+
+// Workload and pattern length used to calibrate each class
+static const Alphabet CLASS_ALPHABET[ALPHABET_CLASSES] = {Alphabet::DNA, Alphabet::English, Alphabet::Bytes};
+static const long CLASS_LENGTH[LENGTH_CLASSES] = {4, 16, 64};
+
+// Only the first chunk of T is scanned to estimate its alphabet
+static const long ALPHABET_SAMPLE = 1 << 16;
+
+double EngineCost::estimate(long n) const {
+  if (t2 <= 0 || n2 <= 0)
+    return INFINITY;
+
+  // Exponent of the power law through both points (about 1 for linear engines, 2 for quadratic)
+  double k = 1;
+  if (t1 > 0 && n1 > 0 && n1 != n2)
+    k = std::clamp(std::log(t2 / t1) / std::log(static_cast<double>(n2) / n1), 0.5, 2.5);
+
+  return t2 * std::pow(static_cast<double>(std::max(1L, n)) / n2, k);
+}
+
+/**
+ * Returns the alphabet class of a query: 0 for at most 4 distinct characters,
+ * 1 for at most 64, and 2 otherwise.
+ */
+int alphabet_class(const std::string& P, const std::string& T) {
+  bool seen[256] = {false};
+  int sigma = 0;
+  auto add = [&](unsigned char c) {
+    sigma += !seen[c];
+    seen[c] = true;
+  };
+
+  for (unsigned char c : P)
+    add(c);
+  long sample = std::min(static_cast<long>(T.length()), ALPHABET_SAMPLE);
+  for (long i{0}; i < sample; ++i)
+    add(T[i]);
+
+  return sigma <= 4 ? 0 : sigma <= 64 ? 1 : 2;
+}
+
+/**
+ * Returns the length class of a pattern: 0 for at most 8 characters,
+ * 1 for at most 32, and 2 otherwise.
+ */
+int length_class(long m) {
+  return m <= 8 ? 0 : m <= 32 ? 1 : 2;
+}
+
+static std::string profile_key(const std::string& engine, int a, int l) {
+  return engine + " " + std::to_string(a) + " " + std::to_string(l);
+}
+
+Planner::Planner(std::string profilePath) : profilePath(profilePath), online(make_matchers()) {
+  load();
+}
+
+void Planner::setTrace(std::ostream* out) {
+  trace = out;
+}
+
+bool Planner::calibrated() const {
+  return !profile.empty();
+}
+
+bool Planner::load() {
+  std::ifstream in(profilePath);
+  if (!in)
+    return false;
+
+  std::string header;
+  std::getline(in, header);
+  if (header != PROFILE_HEADER)
+    return false;
+
+  std::map<std::string, EngineCost> loaded;
+  std::string engine;
+  int a, l;
+  EngineCost cost;
+  while (in >> engine >> a >> l >> cost.n1 >> cost.t1 >> cost.n2 >> cost.t2)
+    loaded[profile_key(engine, a, l)] = cost;
+
+  if (loaded.empty())
+    return false;
+
+  profile = loaded;
+  if (trace)
+    *trace << "[planner] loaded " << profile.size() << " entries from " << profilePath << std::endl;
+  return true;
+}
+
+bool Planner::save() const {
+  std::ofstream out(profilePath);
+  if (!out)
+    return false;
+
+  out << PROFILE_HEADER << "\n";
+  out.precision(9);
+  for (auto& entry : profile) {
+    const EngineCost& c = entry.second;
+    out << entry.first << " " << c.n1 << " " << c.t1 << " " << c.n2 << " " << c.t2 << "\n";
+  }
+
+  return static_cast<bool>(out);
+}
+
+/**
+ * Times one engine on the workload of one class at two text sizes.
+ */
+EngineCost Planner::measure(Matcher& matcher, int alphabetClass, int lengthClass, bool fast) {
+  using clock = std::chrono::steady_clock;
+
+  // zval grows quadratically, so it gets smaller texts
+  bool quadratic = matcher.name() == "zval";
+  long base = quadratic ? 1 << 10 : 1 << 13;
+  double minSeconds = fast ? 0.001 : 0.01;
+
+  EngineCost cost;
+  cost.n1 = base;
+  cost.n2 = base * 4;
+
+  for (int step{0}; step < 2; ++step) {
+    long n = step == 0 ? cost.n1 : cost.n2;
+    Alphabet a = CLASS_ALPHABET[alphabetClass];
+    std::string T = make_text(a, n);
+    std::string P = make_pattern(a, T, CLASS_LENGTH[lengthClass]);
+
+    // Index engines are timed per query only; the index is built beforehand
+    std::vector<int> sa;
+    if (matcher.name() == "sarray") {
+      sa = build_sarray(T);
+      sarray.setIndex(&sa);
+    }
+
+    matcher.prepare(P);
+    long runs = 0;
+    double elapsed = 0;
+    auto start = clock::now();
+    do {
+      matcher.find_all(T, [](long) {});
+      runs++;
+      elapsed = std::chrono::duration<double>(clock::now() - start).count();
+    } while (elapsed < minSeconds);
+
+    sarray.setIndex(nullptr);
+    (step == 0 ? cost.t1 : cost.t2) = elapsed / runs;
+  }
+
+  return cost;
+}
+
+void Planner::calibrate(bool fast) {
+  profile.clear();
+
+  std::vector<Matcher*> engines;
+  for (auto& m : online)
+    engines.push_back(m.get());
+  engines.push_back(&sarray);
+
+  for (int a{0}; a < ALPHABET_CLASSES; ++a) {
+    for (int l{0}; l < LENGTH_CLASSES; ++l) {
+      for (Matcher* m : engines)
+        profile[profile_key(m->name(), a, l)] = measure(*m, a, l, fast);
+    }
+  }
+
+  bool saved = save();
+  if (trace)
+    *trace << "[planner] calibrated " << profile.size() << " entries"
+           << (saved ? ", saved to " : ", could not save to ") << profilePath << std::endl;
+}
+
+Matcher& Planner::choose(const std::string& P, const std::string& T, const std::vector<int>* sa) {
+  if (!calibrated())
+    calibrate();
+
+  long n = T.length();
+  long m = P.length();
+  int a = alphabet_class(P, T);
+  int l = length_class(m);
+  bool indexed = sa && sa->size() == T.length() + 1;
+
+  std::vector<Matcher*> candidates;
+  for (auto& matcher : online)
+    candidates.push_back(matcher.get());
+  sarray.setIndex(indexed ? sa : nullptr);
+  if (indexed)
+    candidates.push_back(&sarray);
+
+  std::ostringstream why;
+  Matcher* best = candidates.front();
+  double bestCost = INFINITY;
+  for (Matcher* matcher : candidates) {
+    auto it = profile.find(profile_key(matcher->name(), a, l));
+    double cost = it == profile.end() ? INFINITY : it->second.estimate(n);
+    why << " " << matcher->name() << "=" << cost * 1e3 << "ms";
+    if (cost < bestCost) {
+      bestCost = cost;
+      best = matcher;
+    }
+  }
+
+  if (trace) {
+    *trace << "[planner] n=" << n << " m=" << m << " alphabet_class=" << a << " length_class=" << l
+           << " indexed=" << (indexed ? "yes" : "no") << " estimates:" << why.str()
+           << " -> " << best->name() << std::endl;
+  }
+
+  return *best;
+}
+
+std::vector<long> Planner::find_all(const std::string& P, const std::string& T, const std::vector<int>* sa) {
+  Matcher& matcher = choose(P, T, sa);
+  matcher.prepare(P);
+  return ::find_all(matcher, T);
+}
@@ -0,0 +1,104 @@
+/**
+ * @file planner.h
+ * Declarations of a query planner that picks the fastest exact matching engine.
+ */
+
+#pragma once
+
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "matcher.h"
+
+/**
+ * One calibration measurement: average seconds per find_all at two text sizes.
+ * Costs at other sizes are extrapolated along the power law through both points.
+ */
+struct EngineCost
+{
+    long n1 = 0;
+    double t1 = 0;
+    long n2 = 0;
+    double t2 = 0;
+
+    // Returns the estimated seconds for a text of length n
+    double estimate(long n) const;
+};
+
+/**
+ * The Planner chooses between naive, bmoore, zval and zalg (and sarray when the
+ * caller already has a suffix array for the text) by pattern length, alphabet size,
+ * text size and index availability.
+ *
+ * Costs come from a one-time micro-benchmark persisted to a profile file, so later
+ * processes load the profile instead of recalibrating.
+ */
+class Planner
+{
+    public:
+        /**
+        * Creates a planner backed by the given profile file.
+        * The profile is loaded if it exists; otherwise the first query calibrates.
+        *
+        * @param profilePath Where the calibration profile is read and written
+        */
+        Planner(std::string profilePath = "matcher_profile.txt");
+
+        /**
+        * Runs the micro-benchmark for every engine and writes the profile file.
+        *
+        * @param fast Use fewer and shorter measurements (for tests)
+        */
+        void calibrate(bool fast = false);
+
+        /**
+        * Reads the profile file; returns false if it is missing or not a valid profile.
+        */
+        bool load();
+
+        /**
+        * Writes the current profile; returns false if the file could not be written.
+        */
+        bool save() const;
+
+        /**
+        * Returns the engine the planner would use for P in T.
+        *
+        * @param P The pattern string
+        * @param T The text string
+        * @param sa A suffix array of T from build_sarray, or nullptr if none is available
+        */
+        Matcher& choose(const std::string& P, const std::string& T, const std::vector<int>* sa = nullptr);
+
+        /**
+        * Returns all match positions of P in T (empty if there is no match),
+        * using the engine picked by choose.
+        */
+        std::vector<long> find_all(const std::string& P, const std::string& T, const std::vector<int>* sa = nullptr);
+
+        /**
+        * Explains every decision on out (nullptr turns tracing off).
+        */
+        void setTrace(std::ostream* out);
+
+        // Returns true once a profile has been loaded or calibrated
+        bool calibrated() const;
+
+    private:
+        std::string profilePath;
+        std::ostream* trace = nullptr;
+
+        std::vector<std::unique_ptr<Matcher>> online;
+        SarrayMatcher sarray;
+
+        // Profile keyed by "engine alphabetClass lengthClass"
+        std::map<std::string, EngineCost> profile;
+
+        EngineCost measure(Matcher& matcher, int alphabetClass, int lengthClass, bool fast);
+};
+
+int alphabet_class(const std::string& P, const std::string& T);
+int length_class(long m);
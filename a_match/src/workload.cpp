@@ -0,0 +1,96 @@
+/**
+ * @file workload.cpp
+ * Code to generate reproducible texts and patterns for the matcher benchmarks.
+ *
+ * No generated text or pattern contains '$', which zval and zalg use as a separator.
+ */
+
+#include <random>
+
+#include "workload.h"
+
+std::string alphabet_name(Alphabet a) {
+  switch (a) {
+    case Alphabet::DNA: return "dna";
+    case Alphabet::English: return "english";
+    case Alphabet::Bytes: return "bytes";
+    case Alphabet::Adversarial: return "adversarial";
+  }
+  return "";
+}
+
+std::vector<Alphabet> all_alphabets() {
+  return {Alphabet::DNA, Alphabet::English, Alphabet::Bytes, Alphabet::Adversarial};
+}
+
+/**
+ * Returns a text of length n drawn from the given alphabet.
+ * English text is a stream of common words; adversarial text is a single repeated letter.
+ *
+ * @param a The kind of text
+ * @param n The text length
+ * @param seed The random seed
+ *
+ * @return An std::string of length n
+ */
+std::string make_text(Alphabet a, long n, unsigned seed) {
+  static const std::vector<std::string> words = {"the", "of", "and", "to", "in", "a", "is",
+    "that", "for", "it", "as", "was", "with", "be", "by", "on", "not", "he", "this", "are",
+    "or", "his", "from", "at", "which", "but", "have", "an", "had", "they", "you", "were",
+    "pattern", "string", "matters", "sonnet", "beauty", "summer", "suffix", "array"};
+
+  std::mt19937 rng(seed);
+  std::string T;
+  T.reserve(n);
+
+  switch (a) {
+    case Alphabet::DNA:
+      while (static_cast<long>(T.length()) < n)
+        T += "ACGT"[rng() % 4];
+      break;
+    case Alphabet::English:
+      while (static_cast<long>(T.length()) < n) {
+        T += words[rng() % words.size()];
+        T += ' ';
+      }
+      T.resize(n);
+      break;
+    case Alphabet::Bytes:
+      while (static_cast<long>(T.length()) < n) {
+        char c = static_cast<char>(1 + rng() % 255);
+        if (c != '$')
+          T += c;
+      }
+      break;
+    case Alphabet::Adversarial:
+      T.assign(n, 'a');
+      break;
+  }
+
+  return T;
+}
+
+/**
+ * Returns a pattern of length m for text T.
+ * Patterns are copied from a random position of T so at least one match exists;
+ * adversarial patterns are a run of 'a' with a 'b' in the middle, which never matches
+ * but forces naive, Boyer-Moore and Z scans to compare about m / 2 characters per alignment.
+ *
+ * @param a The kind of text T was made from
+ * @param T The text
+ * @param m The pattern length (at most |T|)
+ * @param seed The random seed
+ *
+ * @return An std::string of length m
+ */
+std::string make_pattern(Alphabet a, const std::string& T, long m, unsigned seed) {
+  if (a == Alphabet::Adversarial) {
+    std::string P(m, 'a');
+    P[m / 2] = 'b';
+    return P;
+  }
+
+  std::mt19937 rng(seed);
+  long start = rng() % (T.length() - m + 1);
+  return T.substr(start, m);
+}
\ No newline at end of file
@@ -0,0 +1,17 @@
+/**
+ * @file workload.h
+ * Declarations of synthetic texts and patterns for benchmarking matchers.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+// The kinds of text the benchmarks sweep over
+enum class Alphabet { DNA, English, Bytes, Adversarial };
+
+std::string alphabet_name(Alphabet a);
+std::vector<Alphabet> all_alphabets();
+std::string make_text(Alphabet a, long n, unsigned seed = 225);
+std::string make_pattern(Alphabet a, const std::string& T, long m, unsigned seed = 225);
\ No newline at end of file
@@ -0,0 +1,149 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <string>
+#include <iostream>
+#include <vector>
+#include <cstdio>
+#include <sstream>
+
+#include "matcher.h"
+#include "planner.h"
+#include "sarray.h"
+#include "workload.h"
+
+/*
+* Helper functions for basic tests
+*/
+
+void matchAllEngines(std::string P, std::string T, std::vector<long> ans){
+  for(auto& matcher : make_matchers()){
+    matcher->prepare(P);
+    std::vector<long> output = find_all(*matcher, T);
+
+    INFO("Engine " + matcher->name() + " disagrees on P = " + P);
+    REQUIRE(output == ans);
+  }
+}
+
+
+/*
+* Matcher adapter test cases
+*/
+
+TEST_CASE("All engines find every match", "[weight=1]") {
+  matchAllEngines("AAA", "BAAAT", {1});
+  matchAllEngines("pattern", "this is a pattern that has a repeat pattern", {10, 36});
+  matchAllEngines("aa", "aaaaa", {0, 1, 2, 3});
+}
+
+TEST_CASE("All engines report no match without sentinels", "[weight=1]") {
+  matchAllEngines("xyz", "this is a pattern", {});
+  matchAllEngines("longer than the text", "short", {});
+}
+
+TEST_CASE("All engines find matches in texts holding the sentinel", "[weight=1]") {
+  matchAllEngines("abc", "abc$abcabc", {0, 4, 7});
+  matchAllEngines("ab", "$ab$$ab", {1, 5});
+}
+
+TEST_CASE("All engines agree on generated workloads", "[weight=1]") {
+  for(Alphabet a : all_alphabets()){
+    std::string T = make_text(a, 3000);
+    std::string P = make_pattern(a, T, 3);
+
+    std::vector<long> ans;
+    for(size_t i = 0; i + P.length() <= T.length(); ++i){
+      if(T.compare(i, P.length(), P) == 0){
+        ans.push_back(i);
+      }
+    }
+
+    INFO("Alphabet " + alphabet_name(a));
+    matchAllEngines(P, T, ans);
+  }
+}
+
+
+/*
+* Query planner test cases
+*/
+
+std::vector<long> bruteForce(std::string P, std::string T){
+  std::vector<long> ans;
+  for(size_t i = 0; i + P.length() <= T.length(); ++i){
+    if(T.compare(i, P.length(), P) == 0){
+      ans.push_back(i);
+    }
+  }
+  return ans;
+}
+
+TEST_CASE("Planner classifies queries", "[weight=1]") {
+  REQUIRE(alphabet_class("ACG", "ACGTACGT") == 0);
+  REQUIRE(alphabet_class("the", "the quick brown fox") == 1);
+  REQUIRE(length_class(4) == 0);
+  REQUIRE(length_class(20) == 1);
+  REQUIRE(length_class(100) == 2);
+}
+
+TEST_CASE("Planner persists its calibration profile", "[weight=1]") {
+  std::string path = "planner_test_profile.txt";
+  std::remove(path.c_str());
+
+  Planner planner(path);
+  REQUIRE(!planner.calibrated());
+  planner.calibrate(true);
+  REQUIRE(planner.calibrated());
+
+  Planner reloaded(path);
+  REQUIRE(reloaded.calibrated());
+
+  std::remove(path.c_str());
+}
+
+TEST_CASE("Planner finds every match and explains its choice", "[weight=1]") {
+  std::string path = "planner_test_profile.txt";
+  std::remove(path.c_str());
+
+  Planner planner(path);
+  planner.calibrate(true);
+
+  std::ostringstream trace;
+  planner.setTrace(&trace);
+
+  for(Alphabet a : all_alphabets()){
+    std::string T = make_text(a, 2000);
+    std::string P = make_pattern(a, T, 5);
+
+    REQUIRE(planner.find_all(P, T) == bruteForce(P, T));
+
+    std::vector<int> sa = build_sarray(T);
+    REQUIRE(planner.find_all(P.substr(0, 2), T, &sa) == bruteForce(P.substr(0, 2), T));
+  }
+
+  REQUIRE(trace.str().find("indexed=yes") != std::string::npos);
+  REQUIRE(trace.str().find(" -> ") != std::string::npos);
+
+  std::remove(path.c_str());
+}
+
+TEST_CASE("Planner answers a query without matches after one with matches", "[weight=1]") {
+  std::string T = "banana";
+  std::vector<int> sa = build_sarray(T);
+
+  SarrayMatcher sarray;
+  sarray.setIndex(&sa);
+  sarray.prepare("ana");
+  REQUIRE(find_all(sarray, T) == std::vector<long>({1, 3}));
+  sarray.prepare("xyz");
+  REQUIRE(find_all(sarray, T).empty());
+
+  std::string path = "planner_test_profile.txt";
+  std::remove(path.c_str());
+  Planner planner(path);
+  planner.calibrate(true);
+  REQUIRE(planner.find_all("ana", T, &sa) == std::vector<long>({1, 3}));
+  REQUIRE(planner.find_all("xyz", T, &sa).empty());
+  REQUIRE(planner.find_all("nab", T, &sa).empty());
+  std::remove(path.c_str());
+}
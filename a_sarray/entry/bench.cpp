@@ -0,0 +1,264 @@
+/**
+ * @file bench.cpp
+ * Times suffix array construction on a generated text at 32- and 64-bit index widths
+ * and reports throughput, peak memory and the time projected for a 1 GB text,
+ * then the parallel builder at every power-of-two thread count up to the core count,
+ * then compares plain and LCP-accelerated search for patterns of several lengths
+ * and per-query calls against one batched call for the SA ranges of a million short queries,
+ * the memory and query latency of the compressed suffix array at several sample rates,
+ * document listing against deduplicating every occurrence in a collection cut from the text,
+ * and the enhanced suffix array's top-down search against LCP search, with the time of its
+ * bottom-up repeat and frequency analyses.
+ *
+ * Usage: ./bench [TEXT_SIZE_IN_MB]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+
+#include <sys/resource.h>
+
+#include "csa.h"
+#include "doc_index.h"
+#include "esa.h"
+#include "lcp.h"
+#include "sarray.h"
+#include "sarray_batch.h"
+#include "sarray_parallel.h"
+
+// Returns the peak resident set size of this process in MB
+double peak_mb() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss / 1024.0;
+}
+
+int main(int argc, char** argv) {
+  long mb = argc > 1 ? std::atol(argv[1]) : 64;
+  long n = mb << 20;
+
+  // DNA-like text with some long repeats, which stress suffix sorting
+  std::mt19937 rng(225);
+  std::string T;
+  T.reserve(n);
+  while (static_cast<long>(T.length()) < n) {
+    if (T.length() > 1000 && rng() % 64 == 0)
+      T += T.substr(rng() % (T.length() - 1000), 1000);
+    else
+      T += "ACGT"[rng() % 4];
+  }
+  T.resize(n);
+
+  // The 32-bit build runs first so the peak RSS it reports is its own
+  double before = peak_mb();
+  auto start = std::chrono::steady_clock::now();
+  std::vector<uint32_t> sa32 = build_sarray32(T);
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  double saisSeconds = seconds;
+
+  std::cout << "build_sarray32: " << mb << " MB in " << seconds << " s (" << mb / seconds
+            << " MB/s, 1 GB in about " << 1024 * seconds / mb << " s), peak RSS " << peak_mb()
+            << " MB (" << (peak_mb() - before) / mb << " bytes/char above the input)" << std::endl;
+
+  start = std::chrono::steady_clock::now();
+  std::vector<uint64_t> sa64 = build_sarray64(T);
+  seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  bool same = sa32.size() == sa64.size() && std::equal(sa32.begin(), sa32.end(), sa64.begin());
+  std::cout << "build_sarray64: " << mb << " MB in " << seconds << " s (" << mb / seconds
+            << " MB/s, 1 GB in about " << 1024 * seconds / mb << " s), "
+            << (same ? "matches the 32-bit build" : "DIFFERS FROM THE 32-BIT BUILD") << std::endl;
+
+  // Parallel prefix doubling against the serial SA-IS time
+  unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+  std::cout << "threads  parallel s  speedup over 1 thread  over SA-IS" << std::endl;
+  double oneThread = 0;
+  for (unsigned threads{1}; ; threads = std::min(threads * 2, cores)) {
+    start = std::chrono::steady_clock::now();
+    std::vector<int> parallel = build_sarray_parallel(T, threads);
+    double took = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (threads == 1)
+      oneThread = took;
+
+    bool ok = std::equal(parallel.begin(), parallel.end(), sa32.begin(), sa32.end());
+    std::cout << threads << "\t " << took << "\t     " << oneThread / took << "\t\t\t    " << saisSeconds / took
+              << (ok ? "" : "  DIFFERS FROM SA-IS") << std::endl;
+    if (threads == cores)
+      break;
+  }
+
+  // Search needs int indices; long patterns are where skipping matched prefixes pays off
+  std::vector<int> sa = build_sarray(T);
+  start = std::chrono::steady_clock::now();
+  LcpIndex index(T, sa);
+  seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  std::cout << "LcpIndex: built in " << seconds << " s, " << 3 * sa.size() * sizeof(int) / 1048576.0
+            << " MB" << std::endl;
+
+  std::cout << "pattern  plain us/query  lcp us/query" << std::endl;
+  for (long m : {10L, 100L, 1000L, 10000L}) {
+    const int queries = 2000;
+    std::vector<std::string> patterns;
+    for (int q{0}; q < queries; ++q)
+      patterns.push_back(T.substr(rng() % (n - m), m));
+
+    long check = 0;
+    start = std::chrono::steady_clock::now();
+    for (const std::string& P : patterns)
+      check += getLargest(P, T, sa) - getSmallest(P, T, sa) + 1;
+    double plain = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for (const std::string& P : patterns) {
+      std::pair<size_t, size_t> r = index.range(P);
+      check -= r.second - r.first;
+    }
+    double lcp = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << m << "\t " << plain / queries * 1e6 << "\t\t " << lcp / queries * 1e6
+              << (check == 0 ? "" : "  COUNTS DIFFER") << std::endl;
+  }
+
+  // Short queries, as from read mapping, mostly drawn from the text
+  const long queries = 1000000;
+  std::vector<std::string> patterns;
+  for (long q{0}; q < queries; ++q) {
+    long m = 12 + rng() % 9;
+    if (q % 4 == 0) {
+      patterns.emplace_back();
+      for (long k{0}; k < m; ++k)
+        patterns.back() += "ACGT"[rng() % 4];
+    } else {
+      patterns.push_back(T.substr(rng() % (n - m), m));
+    }
+  }
+
+  start = std::chrono::steady_clock::now();
+  long single = 0;
+  for (const std::string& P : patterns) {
+    int first = getSmallest(P, T, sa);
+    if (first != -1)
+      single += getLargest(P, T, sa) - first + 1;
+  }
+  double perQuery = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+  start = std::chrono::steady_clock::now();
+  long batched = 0;
+  for (const std::pair<size_t, size_t>& r : sarray_range_batch(patterns, T, sa, threads))
+    batched += r.second - r.first;
+  double batch = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  std::cout << "1M query ranges: " << perQuery << " s one at a time, " << batch << " s batched on " << threads
+            << " threads (" << perQuery / batch << "x)" << (single == batched ? "" : "  RESULTS DIFFER")
+            << std::endl;
+
+  // The compressed suffix array replaces both the text and the 4 bytes per character of SA
+  std::cout << "rate   csa MB   bytes/char   us per count   us per located match" << std::endl;
+  for (unsigned long rate : {16UL, 64UL, 256UL}) {
+    CompressedSarray csa(T, sa, rate);
+    const int counts = 2000;
+    long found = 0;
+    bool ok = true;
+    start = std::chrono::steady_clock::now();
+    for (int q{0}; q < counts; ++q) {
+      const std::string& P = patterns[q];
+      found += csa.count(P);
+    }
+    double countSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    long located = 0;
+    start = std::chrono::steady_clock::now();
+    for (int q{0}; q < counts && located < 20000; ++q) {
+      std::vector<int> out = csa.locate(patterns[q]);
+      if (out[0] != -1) {
+        ok = ok && out == sarray_search(patterns[q], T, sa);
+        located += out.size();
+      }
+    }
+    double locateSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << rate << "\t" << csa.bytes() / 1048576.0 << "\t " << static_cast<double>(csa.bytes()) / n << "\t      "
+              << countSeconds / counts * 1e6 << "\t     " << locateSeconds / std::max(1L, located) * 1e6
+              << (ok ? "" : "  LOCATE DIFFERS") << std::endl;
+  }
+
+  // Popular patterns occur many times per document; listing should cost per document, not per occurrence
+  std::vector<std::string> docs;
+  for (long i{0}; i < n; i += 4096)
+    docs.push_back(T.substr(i, 4096));
+  DocumentIndex collection(docs);
+  std::cout << "pattern  occurrences  documents  us to list  us to dedupe occurrences" << std::endl;
+  for (long m : {3L, 5L, 8L}) {
+    std::string P = T.substr(n / 2, m);
+    start = std::chrono::steady_clock::now();
+    std::vector<int> listed = collection.listDocuments(P);
+    double listSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    std::vector<std::pair<int, int>> found = collection.search(P);
+    std::vector<bool> seen(docs.size(), false);
+    long distinct = 0;
+    for (const std::pair<int, int>& match : found) {
+      distinct += !seen[match.first];
+      seen[match.first] = true;
+    }
+    double dedupeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << P << "\t " << found.size() << "\t      " << listed.size() << "\t " << listSeconds * 1e6 << "\t     "
+              << dedupeSeconds * 1e6 << (distinct == static_cast<long>(listed.size()) ? "" : "  COUNTS DIFFER")
+              << std::endl;
+  }
+
+  // Walking child intervals replaces binary search; the same arrays then serve whole-text analyses
+  start = std::chrono::steady_clock::now();
+  EnhancedSarray esa(T, sa);
+  seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  std::cout << "EnhancedSarray: built in " << seconds << " s, " << 2 * sa.size() * sizeof(int) / 1048576.0
+            << " MB besides SA" << std::endl;
+
+  std::cout << "pattern  lcp us/query  esa us/query" << std::endl;
+  for (long m : {10L, 100L, 1000L}) {
+    const int queries = 20000;
+    std::vector<std::string> patterns;
+    for (int q{0}; q < queries; ++q)
+      patterns.push_back(T.substr(rng() % (n - m), m));
+
+    long check = 0;
+    start = std::chrono::steady_clock::now();
+    for (const std::string& P : patterns)
+      check += index.range(P).first;
+    double lcp = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for (const std::string& P : patterns)
+      check -= esa.range(P).first;
+    double walk = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << m << "\t " << lcp / queries * 1e6 << "\t\t" << walk / queries * 1e6
+              << (check == 0 ? "" : "  RANGES DIFFER") << std::endl;
+  }
+
+  start = std::chrono::steady_clock::now();
+  Repeat longest = esa.longestRepeat();
+  seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  std::cout << "longest repeat: " << longest.length << " chars x " << longest.count << " in " << seconds << " s"
+            << std::endl;
+
+  start = std::chrono::steady_clock::now();
+  size_t repeats = esa.maximalRepeats(20).size();
+  seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  std::cout << "maximal repeats of 20+ chars: " << repeats << " in " << seconds << " s" << std::endl;
+
+  start = std::chrono::steady_clock::now();
+  size_t kmers = esa.frequencies(12).size();
+  seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  std::cout << "distinct 12-mers: " << kmers << " counted in " << seconds << " s" << std::endl;
+
+  return 0;
+}
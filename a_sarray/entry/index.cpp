@@ -0,0 +1,74 @@
+/**
+ * @file index.cpp
+ * Builds a suffix array index file for a text file, or opens one and searches it.
+ * Opening maps the file instead of reading it, so a query worker starts in milliseconds
+ * however large the index is.
+ *
+ * Usage: ./index build TEXT_FILE INDEX_FILE [--lcp]
+ *        ./index query INDEX_FILE PATTERN...
+ */
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+
+#include "lcp.h"
+#include "sarray.h"
+#include "sarray_file.h"
+
+int main(int argc, char** argv) {
+  std::string mode = argc > 1 ? argv[1] : "";
+  if (!(mode == "build" && argc >= 4) && !(mode == "query" && argc >= 3)) {
+    std::cerr << "Usage: " << argv[0] << " build TEXT_FILE INDEX_FILE [--lcp]" << std::endl;
+    std::cerr << "       " << argv[0] << " query INDEX_FILE PATTERN..." << std::endl;
+    return 1;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  auto elapsed = [&start]() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  };
+
+  if (mode == "build") {
+    std::ifstream in(argv[2], std::ios::binary);
+    if (!in) {
+      std::cerr << "Cannot read " << argv[2] << std::endl;
+      return 1;
+    }
+    std::string T((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    std::vector<int> sarray = build_sarray(T);
+    if (sarray.empty()) {
+      std::cerr << argv[2] << " is too large for an int suffix array" << std::endl;
+      return 1;
+    }
+    std::vector<int> lcp;
+    bool withLcp = argc > 4 && std::string(argv[4]) == "--lcp";
+    if (withLcp)
+      lcp = build_lcp(T, sarray);
+
+    if (!SarrayFile::write(argv[3], T, sarray, withLcp ? &lcp : nullptr)) {
+      std::cerr << "Cannot write " << argv[3] << std::endl;
+      return 1;
+    }
+    std::cout << "Indexed " << T.length() << " characters in " << elapsed() << " s" << std::endl;
+    return 0;
+  }
+
+  SarrayFile index;
+  if (!index.open(argv[2])) {
+    std::cerr << argv[2] << " is not a valid index file" << std::endl;
+    return 1;
+  }
+  std::cout << "Opened " << index.text().length() << " characters in " << elapsed() * 1000 << " ms" << std::endl;
+
+  for (int i{3}; i < argc; ++i) {
+    std::vector<int> matches = index.search(argv[i]);
+    long count = matches.front() == -1 ? 0 : matches.size();
+    std::cout << argv[i] << ": " << count << " matches" << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,234 @@
+/**
+ * @file csa.cpp
+ * Code to build and query the Psi-based compressed suffix array.
+ */
+
+#include <algorithm>
+
+#include "csa.h"
+
+/**
+ * Writes the low width bits of value at bit size of words (least significant bit first).
+ */
+static void append_bits(std::vector<uint64_t>& words, uint64_t& size, uint64_t value, unsigned width) {
+  // Reads may look one word past the last bit, so one spare word always follows
+  while (words.size() < (size + width) / 64 + 2)
+    words.push_back(0);
+
+  unsigned offset = size % 64;
+  words[size / 64] |= value << offset;
+  if (offset + width > 64)
+    words[size / 64 + 1] |= value >> (64 - offset);
+  size += width;
+}
+
+/**
+ * Returns the 64 bits of words starting at bit pos.
+ */
+static uint64_t window(const std::vector<uint64_t>& words, uint64_t pos) {
+  unsigned offset = pos % 64;
+  uint64_t w = words[pos / 64] >> offset;
+  if (offset)
+    w |= words[pos / 64 + 1] << (64 - offset);
+  return w;
+}
+
+/**
+ * Appends the Elias-gamma code of d >= 1: as many zeros as d has bits after its leading one,
+ * a one, then those bits.
+ */
+static void append_gamma(std::vector<uint64_t>& words, uint64_t& size, uint64_t d) {
+  unsigned L = 63 - __builtin_clzll(d);
+  size += L;
+  append_bits(words, size, ((d & ((1ULL << L) - 1)) << 1) | 1, L + 1);
+}
+
+/**
+ * Reads the Elias-gamma code at bit pos and moves pos past it.
+ */
+static uint64_t read_gamma(const std::vector<uint64_t>& words, uint64_t& pos) {
+  unsigned L = __builtin_ctzll(window(words, pos));
+  uint64_t low = L == 0 ? 0 : window(words, pos + L + 1) & ((1ULL << L) - 1);
+  pos += 2 * L + 1;
+  return (1ULL << L) | low;
+}
+
+CompressedSarray::CompressedSarray(const std::string& T, const std::vector<int>& sarray, unsigned long sampleRate)
+  : sampleRate(sampleRate == 0 ? 1 : sampleRate) {
+  // Anything but a suffix array of T gives an empty structure
+  if (sarray.size() != T.length() + 1 || T.length() >= UINT32_MAX - 1)
+    return;
+  n = T.length();
+  size_t N = n + 1;
+
+  std::vector<uint32_t> isa(N);
+  for (size_t i{0}; i < N; ++i)
+    isa[sarray[i]] = i;
+
+  // Buckets of the characters present; rank 0 is the sentinel's
+  size_t count[256] = {0};
+  for (unsigned char c : T)
+    count[c]++;
+  size_t rank = 1;
+  for (int c{0}; c < 256; ++c) {
+    if (count[c] == 0)
+      continue;
+    symbols += static_cast<char>(c);
+    bucketStart.push_back(rank);
+    rank += count[c];
+  }
+  bucketStart.push_back(N);
+
+  // Psi plus N per bucket passed increases strictly, so every gap is at least 1
+  uint64_t size = 0;
+  uint64_t prev = 0;
+  for (size_t i{0}, bucket{0}; i < N; ++i) {
+    while (bucket < symbols.length() && i >= bucketStart[bucket])
+      bucket++;
+    uint64_t value = bucket * N + isa[(sarray[i] + 1) % N];
+    if (i % CSA_PSI_BLOCK == 0) {
+      blockValue.push_back(value);
+      blockOffset.push_back(size);
+    } else {
+      append_gamma(bits, size, value - prev);
+    }
+    prev = value;
+  }
+  bits.resize(size / 64 + 2);
+
+  // Sample every sampleRate-th position and the end of the text, which every walk reaches at worst
+  sampled.assign(N / 64 + 1, 0);
+  for (size_t i{0}; i < N; ++i) {
+    size_t p = sarray[i];
+    if (p % this->sampleRate == 0 || p == n) {
+      sampled[i / 64] |= 1ULL << (i % 64);
+      saSample.push_back(p);
+    }
+  }
+  uint32_t before = 0;
+  for (uint64_t word : sampled) {
+    sampledBefore.push_back(before);
+    before += __builtin_popcountll(word);
+  }
+  for (size_t p{0}; p < N; p += this->sampleRate)
+    isaSample.push_back(isa[p]);
+
+  bits.shrink_to_fit();
+  blockValue.shrink_to_fit();
+  blockOffset.shrink_to_fit();
+  saSample.shrink_to_fit();
+  isaSample.shrink_to_fit();
+}
+
+size_t CompressedSarray::psi(size_t i) const {
+  size_t block = i / CSA_PSI_BLOCK;
+  uint64_t value = blockValue[block];
+  uint64_t pos = blockOffset[block];
+  for (size_t j{block * CSA_PSI_BLOCK}; j < i; ++j)
+    value += read_gamma(bits, pos);
+  return value % (n + 1);
+}
+
+unsigned char CompressedSarray::first(size_t i) const {
+  // The last bucket starting at or before i
+  size_t lo = 0;
+  size_t hi = symbols.length();
+  while (hi - lo > 1) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (bucketStart[mid] <= i)
+      lo = mid;
+    else
+      hi = mid;
+  }
+  return symbols[lo];
+}
+
+size_t CompressedSarray::position(size_t i) const {
+  size_t steps = 0;
+  while (!(sampled[i / 64] >> (i % 64) & 1)) {
+    i = psi(i);
+    steps++;
+  }
+
+  uint64_t below = sampled[i / 64] & ((1ULL << (i % 64)) - 1);
+  return saSample[sampledBefore[i / 64] + __builtin_popcountll(below)] - steps;
+}
+
+size_t CompressedSarray::firstRank(const std::string& P, bool strict) const {
+  size_t lo = 0;
+  size_t hi = n + 1;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+
+    // Read the suffix at mid one character at a time; reaching rank 0 means it has ended
+    int cmp = 0;
+    size_t r = mid;
+    for (size_t k{0}; k < P.length() && cmp == 0; ++k) {
+      if (r == 0) {
+        cmp = -1;
+        break;
+      }
+      unsigned char c = first(r);
+      unsigned char p = P[k];
+      cmp = c < p ? -1 : c > p ? 1 : 0;
+      r = psi(r);
+    }
+
+    if (cmp < 0 || (strict && cmp == 0))
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+size_t CompressedSarray::count(const std::string& P) const {
+  if (bucketStart.empty())
+    return 0;
+  return firstRank(P, true) - firstRank(P, false);
+}
+
+std::vector<int> CompressedSarray::locate(const std::string& P) const {
+  if (bucketStart.empty())
+    return {-1};
+
+  size_t begin = firstRank(P, false);
+  size_t end = firstRank(P, true);
+  if (begin == end)
+    return {-1};
+
+  std::vector<int> out;
+  for (size_t i{begin}; i < end; ++i)
+    out.push_back(position(i));
+  return out;
+}
+
+std::string CompressedSarray::extract(size_t i, size_t len) const {
+  if (i >= n)
+    return "";
+  len = std::min(len, n - i);
+
+  // Start from the sample at or before i and walk forward to it
+  size_t r = isaSample[i / sampleRate];
+  for (size_t p{i / sampleRate * sampleRate}; p < i; ++p)
+    r = psi(r);
+
+  std::string out;
+  out.reserve(len);
+  for (size_t k{0}; k < len; ++k) {
+    out += static_cast<char>(first(r));
+    r = psi(r);
+  }
+  return out;
+}
+
+size_t CompressedSarray::length() const {
+  return n;
+}
+
+size_t CompressedSarray::bytes() const {
+  return sizeof(*this) + symbols.capacity() +
+         (bucketStart.capacity() + bits.capacity() + blockValue.capacity() + blockOffset.capacity() +
+          sampled.capacity()) * sizeof(uint64_t) +
+         (sampledBefore.capacity() + saSample.capacity() + isaSample.capacity()) * sizeof(uint32_t);
+}
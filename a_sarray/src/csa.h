@@ -0,0 +1,108 @@
+/**
+ * @file csa.h
+ * Declarations of a compressed suffix array built on the Psi function (Sadakane).
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Default distance between sampled text positions for locate and extract
+const unsigned long CSA_SAMPLE_RATE = 64;
+
+// Psi entries per block; each block starts from an absolute value and bit offset
+const size_t CSA_PSI_BLOCK = 128;
+
+/**
+ * A suffix array of T + '$' that replaces both the array and the text.
+ *
+ * Psi[i] is the rank of the suffix one position after the suffix at rank i (rank 0, the
+ * sentinel, wraps to the whole text). Within the ranks of suffixes starting with one character
+ * Psi increases, so adding N per character bucket makes it increase throughout; the gaps are
+ * Elias-gamma coded in blocks of CSA_PSI_BLOCK. A suffix is read by taking the character
+ * whose bucket holds its rank, then following Psi, so count needs neither T nor SA.
+ *
+ * Every sampleRate-th text position keeps its rank (inverse SA sample), and ranks holding
+ * such a position keep the position (SA sample, found through a bitvector with rank support).
+ * locate walks Psi to the next sample and extract starts from the one before its first
+ * position, so both cost O(sampleRate) Psi steps per position; samples take 8 / sampleRate
+ * bytes per character.
+ */
+class CompressedSarray
+{
+    public:
+        /**
+        * Builds the compressed suffix array; T and sarray can be freed afterwards.
+        *
+        * @param T The text [excluding '$'], shorter than 2^32 - 1 characters
+        * @param sarray The suffix array of T from build_sarray
+        * @param sampleRate The distance between sampled text positions
+        */
+        CompressedSarray(const std::string& T, const std::vector<int>& sarray,
+                         unsigned long sampleRate = CSA_SAMPLE_RATE);
+
+        /**
+        * Returns the number of occurrences of P in T.
+        */
+        size_t count(const std::string& P) const;
+
+        /**
+        * Returns the positions of P in T in suffix array order, or {-1} if none, as sarray_search does.
+        */
+        std::vector<int> locate(const std::string& P) const;
+
+        /**
+        * Returns T[i, i + len), cut short at the end of the text ("" if i is past the end).
+        */
+        std::string extract(size_t i, size_t len) const;
+
+        // Returns the length of the text (without the sentinel)
+        size_t length() const;
+
+        // Returns the bytes held by the structure
+        size_t bytes() const;
+
+    private:
+        /**
+        * Returns Psi[i].
+        */
+        size_t psi(size_t i) const;
+
+        /**
+        * Returns the first character of the suffix at rank i, which must not be 0.
+        */
+        unsigned char first(size_t i) const;
+
+        /**
+        * Returns the text position of the suffix at rank i.
+        */
+        size_t position(size_t i) const;
+
+        /**
+        * Returns the first rank whose suffix, cut to |P| characters, is not smaller than P
+        * (or, if strict, is larger than P).
+        */
+        size_t firstRank(const std::string& P, bool strict) const;
+
+        size_t n = 0;
+        unsigned long sampleRate;
+
+        // Characters present in T in order, and the first rank of each one's bucket (plus N at the end)
+        std::string symbols;
+        std::vector<uint64_t> bucketStart;
+
+        // Gamma-coded gaps of Psi + N * bucket, with each block's first value and bit offset
+        std::vector<uint64_t> bits;
+        std::vector<uint64_t> blockValue;
+        std::vector<uint64_t> blockOffset;
+
+        // sampled[i] is set for ranks holding a sampled position; sampledBefore[w] counts set bits before word w
+        std::vector<uint64_t> sampled;
+        std::vector<uint32_t> sampledBefore;
+
+        // saSample: positions of sampled ranks in rank order; isaSample[k]: rank of position k * sampleRate
+        std::vector<uint32_t> saSample;
+        std::vector<uint32_t> isaSample;
+};
@@ -0,0 +1,188 @@
+/**
+ * @file doc_index.cpp
+ * Code to build and query the generalized suffix array of a document collection.
+ */
+
+#include <algorithm>
+#include <climits>
+#include <string_view>
+
+#include "doc_index.h"
+#include "sais.h"
+
+DocumentIndex::DocumentIndex(const std::vector<std::string>& docs) {
+  size_t total = docs.size();
+  for (const std::string& doc : docs)
+    total += doc.length();
+  if (docs.empty() || total >= static_cast<size_t>(INT_MAX))
+    return;
+
+  int D = docs.size();
+  int N = total;
+  for (const std::string& doc : docs) {
+    docStart.push_back(text.length());
+    text += doc;
+    text += '\0';
+  }
+  docStart.push_back(N);
+
+  // Bytes become D + byte; the separator after document d becomes D - 1 - d, so the last one,
+  // which ends the whole string, is the unique smallest symbol SA-IS expects
+  std::vector<int> symbols(N);
+  for (int d{0}; d < D; ++d) {
+    for (int i{docStart[d]}; i < docStart[d + 1] - 1; ++i)
+      symbols[i] = D + static_cast<unsigned char>(text[i]);
+    symbols[docStart[d + 1] - 1] = D - 1 - d;
+  }
+  SA.resize(N);
+  sais(symbols, SA.data(), N, D + 255);
+
+  // Reuse the symbols as the document of every position
+  for (int d{0}; d < D; ++d)
+    std::fill(symbols.begin() + docStart[d], symbols.begin() + docStart[d + 1], d);
+  DA.resize(N);
+  prev.resize(N);
+  std::vector<int> last(D, -1);
+  for (int i{0}; i < N; ++i) {
+    DA[i] = symbols[SA[i]];
+    prev[i] = last[DA[i]];
+    last[DA[i]] = i;
+  }
+
+  // Within each block, the smallest prev from its start up to each rank and from each rank to its end
+  fromStart.resize(N);
+  toEnd.resize(N);
+  size_t blocks = (N + DOC_INDEX_RMQ_BLOCK - 1) / DOC_INDEX_RMQ_BLOCK;
+  for (size_t b{0}; b < blocks; ++b) {
+    size_t start = b * DOC_INDEX_RMQ_BLOCK;
+    size_t end = std::min<size_t>(N, start + DOC_INDEX_RMQ_BLOCK);
+    for (size_t i{start}, best{start}; i < end; ++i) {
+      if (prev[i] < prev[best])
+        best = i;
+      fromStart[i] = best - start;
+    }
+    for (size_t i{end}, best{end - 1}; i-- > start;) {
+      if (prev[i] <= prev[best])
+        best = i;
+      toEnd[i] = best - start;
+    }
+  }
+
+  // Sparse table over the minimum of each block
+  table.emplace_back(blocks);
+  for (size_t b{0}; b < blocks; ++b) {
+    size_t start = b * DOC_INDEX_RMQ_BLOCK;
+    size_t last = std::min<size_t>(N, start + DOC_INDEX_RMQ_BLOCK) - 1;
+    table[0][b] = start + fromStart[last];
+  }
+  for (size_t k{1}; (1UL << k) <= blocks; ++k) {
+    const std::vector<int>& below = table[k - 1];
+    std::vector<int> level(blocks - (1UL << k) + 1);
+    for (size_t b{0}; b < level.size(); ++b) {
+      int left = below[b];
+      int right = below[b + (1UL << (k - 1))];
+      level[b] = prev[right] < prev[left] ? right : left;
+    }
+    table.push_back(std::move(level));
+  }
+}
+
+size_t DocumentIndex::minPrev(size_t l, size_t r) const {
+  size_t best = l;
+  auto consider = [this, &best](size_t i) {
+    if (prev[i] < prev[best])
+      best = i;
+  };
+
+  // Inside one block, scan; otherwise combine the two partial blocks with the whole ones between
+  size_t firstBlock = l / DOC_INDEX_RMQ_BLOCK;
+  size_t lastBlock = (r - 1) / DOC_INDEX_RMQ_BLOCK;
+  if (firstBlock == lastBlock) {
+    for (size_t i{l}; i < r; ++i)
+      consider(i);
+    return best;
+  }
+
+  consider(firstBlock * DOC_INDEX_RMQ_BLOCK + toEnd[l]);
+  consider(lastBlock * DOC_INDEX_RMQ_BLOCK + fromStart[r - 1]);
+  if (lastBlock - firstBlock > 1) {
+    size_t count = lastBlock - firstBlock - 1;
+    size_t k = 63 - __builtin_clzll(count);
+    consider(table[k][firstBlock + 1]);
+    consider(table[k][lastBlock - (1UL << k)]);
+  }
+  return best;
+}
+
+std::pair<size_t, size_t> DocumentIndex::range(const std::string& P) const {
+  // A suffix is compared only up to the end of its document
+  std::string_view T(text);
+  auto compare = [this, &T, &P](size_t rank) {
+    size_t pos = SA[rank];
+    size_t end = docStart[DA[rank] + 1] - 1;
+    return T.substr(pos, std::min(P.length(), end - pos)).compare(P);
+  };
+
+  size_t bounds[2];
+  for (int strict{0}; strict < 2; ++strict) {
+    size_t lo = 0;
+    size_t hi = SA.size();
+    while (lo < hi) {
+      size_t mid = lo + (hi - lo) / 2;
+      int cmp = compare(mid);
+      if (cmp < 0 || (strict && cmp == 0))
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+    bounds[strict] = lo;
+  }
+
+  return {bounds[0], bounds[1]};
+}
+
+std::vector<std::pair<int, int>> DocumentIndex::search(const std::string& P) const {
+  std::pair<size_t, size_t> r = range(P);
+  std::vector<std::pair<int, int>> out;
+  for (size_t i{r.first}; i < r.second; ++i)
+    out.emplace_back(DA[i], SA[i] - docStart[DA[i]]);
+  return out;
+}
+
+std::vector<int> DocumentIndex::listDocuments(const std::string& P) const {
+  std::pair<size_t, size_t> r = range(P);
+  size_t begin = r.first;
+
+  // The smallest prev in an interval is a document's first rank in it exactly when it falls
+  // before the interval; otherwise every document of the interval has been reported
+  std::vector<int> out;
+  std::vector<std::pair<size_t, size_t>> pending = {r};
+  while (!pending.empty()) {
+    size_t l = pending.back().first;
+    size_t h = pending.back().second;
+    pending.pop_back();
+    if (l >= h)
+      continue;
+
+    size_t k = minPrev(l, h);
+    if (prev[k] >= static_cast<int>(begin))
+      continue;
+    out.push_back(DA[k]);
+    pending.emplace_back(l, k);
+    pending.emplace_back(k + 1, h);
+  }
+
+  return out;
+}
+
+size_t DocumentIndex::documents() const {
+  return docStart.empty() ? 0 : docStart.size() - 1;
+}
+
+const std::vector<int>& DocumentIndex::sarray() const {
+  return SA;
+}
+
+const std::vector<int>& DocumentIndex::docArray() const {
+  return DA;
+}
@@ -0,0 +1,86 @@
+/**
+ * @file doc_index.h
+ * Declarations of a generalized suffix array over a collection of documents.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Entries of the previous-occurrence array per block of the range-minimum index (at most 256)
+const size_t DOC_INDEX_RMQ_BLOCK = 64;
+
+/**
+ * One suffix array over every document of a collection, with the document of each suffix
+ * alongside it (the document array).
+ *
+ * Documents are concatenated, each followed by a separator of its own that sorts below every
+ * byte, so a match never runs from one document into the next and any byte may appear in them.
+ * prev[i] is the last rank before i holding a suffix of the same document (-1 if none): in a
+ * rank interval, the ranks whose prev falls before the interval are exactly one per document,
+ * and a range-minimum index over prev finds them one at a time (Muthukrishnan 2002).
+ * Document listing therefore costs O(distinct documents) range-minimum queries, however often
+ * each document matches.
+ */
+class DocumentIndex
+{
+    public:
+        /**
+        * Builds the index of a collection, holding 15 bytes per character plus the block minima.
+        *
+        * @param docs The documents, whose total length plus count must fit in an int
+        */
+        DocumentIndex(const std::vector<std::string>& docs);
+
+        /**
+        * Returns every occurrence of P as a (document, offset) pair in suffix array order,
+        * or an empty vector if there is none.
+        */
+        std::vector<std::pair<int, int>> search(const std::string& P) const;
+
+        /**
+        * Returns each document containing P once, in no particular order.
+        */
+        std::vector<int> listDocuments(const std::string& P) const;
+
+        // Returns the number of documents
+        size_t documents() const;
+
+        // Returns the generalized suffix array (positions in the concatenation, separators included)
+        const std::vector<int>& sarray() const;
+
+        // Returns the document array: the document of the suffix at each rank
+        const std::vector<int>& docArray() const;
+
+    private:
+        /**
+        * Returns the ranks [first, last) of the suffixes that start with P.
+        */
+        std::pair<size_t, size_t> range(const std::string& P) const;
+
+        /**
+        * Returns the rank in [l, r) whose prev is smallest (l < r).
+        */
+        size_t minPrev(size_t l, size_t r) const;
+
+        // The documents concatenated, with a '\0' standing in for each separator
+        std::string text;
+
+        // docStart[d]: where document d starts in text; the last entry is text.length()
+        std::vector<int> docStart;
+
+        std::vector<int> SA;
+        std::vector<int> DA;
+        std::vector<int> prev;
+
+        // Offsets within the block of the smallest prev from the block's start to each rank,
+        // and from each rank to the block's end
+        std::vector<uint8_t> fromStart;
+        std::vector<uint8_t> toEnd;
+
+        // table[k][b]: the rank of the smallest prev in blocks [b, b + 2^k)
+        std::vector<std::vector<int>> table;
+};
@@ -0,0 +1,194 @@
+/**
+ * @file esa.cpp
+ * Code to build the child table of an enhanced suffix array and traverse its lcp-intervals.
+ */
+
+#include <algorithm>
+
+#include "esa.h"
+#include "lcp.h"
+
+EnhancedSarray::EnhancedSarray(const std::string& T, const std::vector<int>& sarray)
+  : T(T), sarray(sarray), LCP(build_lcp(T, sarray)), child(sarray.size(), 0) {
+  size_t N = sarray.size();
+
+  // up and down: popping the ranks whose LCP exceeds LCP[i] closes the intervals ending at i - 1,
+  // and the last rank popped is the first l-index of the innermost one still open
+  std::vector<size_t> stack{0};
+  size_t last = 0;
+  for (size_t i{1}; i <= N; ++i) {
+    while (lcpAt(i) < lcpAt(stack.back())) {
+      last = stack.back();
+      stack.pop_back();
+      size_t top = stack.back();
+      if (lcpAt(i) <= lcpAt(top) && lcpAt(top) != lcpAt(last))
+        child[top] = last;
+    }
+    if (last != 0) {
+      child[i - 1] = last;
+      last = 0;
+    }
+    stack.push_back(i);
+  }
+
+  // nextlIndex: rank i follows the l-index on top of the stack if nothing smaller lies between them
+  stack.assign(1, 0);
+  for (size_t i{1}; i < N; ++i) {
+    while (lcpAt(i) < lcpAt(stack.back()))
+      stack.pop_back();
+    if (lcpAt(i) == lcpAt(stack.back())) {
+      child[stack.back()] = i;
+      stack.pop_back();
+    }
+    stack.push_back(i);
+  }
+}
+
+int EnhancedSarray::lcpAt(size_t i) const {
+  return i == 0 || i == LCP.size() ? -1 : LCP[i];
+}
+
+size_t EnhancedSarray::firstIndex(size_t i, size_t j) const {
+  // up[j + 1] exists only where the LCP drops after j
+  if (lcpAt(j) > lcpAt(j + 1)) {
+    size_t up = child[j];
+    if (i < up && up <= j)
+      return up;
+  }
+  return child[i];
+}
+
+size_t EnhancedSarray::nextIndex(size_t k) const {
+  // child[k] may instead hold down[k], which lies deeper, or up[k + 1], which lies before k
+  size_t next = child[k];
+  return next > k && lcpAt(next) == lcpAt(k) ? next : 0;
+}
+
+int EnhancedSarray::charAt(size_t r, size_t d) const {
+  size_t pos = sarray[r] + d;
+  return pos < T.length() ? static_cast<unsigned char>(T[pos]) : -1;
+}
+
+std::pair<size_t, size_t> EnhancedSarray::range(const std::string& P) const {
+  size_t m = P.length();
+  size_t i = 0;
+  size_t j = sarray.size() - 1;
+  size_t matched = 0;
+  while (matched < m) {
+    // A single suffix left: the rest of P must match it directly
+    if (i == j) {
+      size_t pos = sarray[i];
+      if (T.length() - pos < m || T.compare(pos + matched, m - matched, P, matched, m - matched) != 0)
+        return {0, 0};
+      break;
+    }
+
+    // Every suffix in the interval shares its first l characters, so check P against one of them
+    size_t k = firstIndex(i, j);
+    size_t l = LCP[k];
+    size_t end = std::min(l, m);
+    if (T.compare(sarray[i] + matched, end - matched, P, matched, end - matched) != 0)
+      return {0, 0};
+    matched = end;
+    if (matched == m)
+      break;
+
+    // Then step into the child interval whose suffixes continue with P[l]. Children are in
+    // lexicographic order, so the scan stops at the first larger character, and the last child
+    // is entered unchecked since the next comparison starts at P[l] anyway.
+    int c = static_cast<unsigned char>(P[l]);
+    size_t lo = i;
+    while (k != 0) {
+      int first = charAt(lo, l);
+      if (first == c)
+        break;
+      if (first > c)
+        return {0, 0};
+      lo = k;
+      k = nextIndex(k);
+    }
+    i = lo;
+    j = k ? k - 1 : j;
+  }
+
+  return {i, j + 1};
+}
+
+std::vector<int> EnhancedSarray::search(const std::string& P) const {
+  std::pair<size_t, size_t> r = range(P);
+  if (r.first == r.second)
+    return {-1};
+
+  return std::vector<int>(sarray.begin() + r.first, sarray.begin() + r.second);
+}
+
+void EnhancedSarray::bottomUp(const std::function<void(int, size_t, size_t)>& visit) const {
+  // Open intervals as (l, left bound); the root 0-[0..N-1] stays at the bottom and is never reported
+  size_t N = sarray.size();
+  std::vector<std::pair<int, size_t>> stack{{0, 0}};
+  for (size_t i{1}; i <= N; ++i) {
+    int l = i < N ? LCP[i] : 0;
+    size_t lb = i - 1;
+    while (l < stack.back().first) {
+      lb = stack.back().second;
+      visit(stack.back().first, lb, i - 1);
+      stack.pop_back();
+    }
+    if (l > stack.back().first)
+      stack.push_back({l, lb});
+  }
+}
+
+Repeat EnhancedSarray::longestRepeat() const {
+  Repeat best{0, 0, 0};
+  bottomUp([&](int l, size_t i, size_t j) {
+    if (l > best.length)
+      best = {sarray[i], l, static_cast<int>(j - i + 1)};
+  });
+  return best;
+}
+
+std::vector<Repeat> EnhancedSarray::maximalRepeats(int minLength) const {
+  // Every lcp-interval is right-maximal; it is also left-maximal unless all its suffixes are
+  // preceded by the same character. changes[r] counts the ranks up to r whose preceding
+  // character differs from that of rank r - 1, where the suffix at 0 differs from everything.
+  size_t N = sarray.size();
+  std::vector<int> changes(N, 0);
+  for (size_t r{1}; r < N; ++r) {
+    bool differs = sarray[r] == 0 || sarray[r - 1] == 0 || T[sarray[r] - 1] != T[sarray[r - 1] - 1];
+    changes[r] = changes[r - 1] + differs;
+  }
+
+  std::vector<Repeat> repeats;
+  bottomUp([&](int l, size_t i, size_t j) {
+    if (l >= minLength && changes[j] != changes[i])
+      repeats.push_back({sarray[i], l, static_cast<int>(j - i + 1)});
+  });
+  return repeats;
+}
+
+std::vector<Repeat> EnhancedSarray::frequencies(int k, int minCount) const {
+  // The suffixes starting with one k-character substring are consecutive ranks joined by LCP >= k,
+  // so a single scan of the LCP array groups them; suffixes shorter than k are skipped
+  std::vector<Repeat> table;
+  if (k < 1)
+    return table;
+
+  size_t N = sarray.size();
+  long n = T.length();
+  for (size_t r{0}; r < N; ++r) {
+    if (n - sarray[r] < k)
+      continue;
+    size_t first = r;
+    while (r + 1 < N && LCP[r + 1] >= k)
+      r++;
+    int count = r - first + 1;
+    if (count >= minCount)
+      table.push_back({sarray[first], k, count});
+  }
+  return table;
+}
+
+const std::vector<int>& EnhancedSarray::lcp() const {
+  return LCP;
+}
@@ -0,0 +1,112 @@
+/**
+ * @file esa.h
+ * Declarations of the enhanced suffix array of Abouelhoda, Kurtz and Ohlebusch.
+ */
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * A substring of T occurring count times, given by one of its positions and its length.
+ */
+struct Repeat
+{
+  int position;
+  int length;
+  int count;
+};
+
+/**
+ * A suffix array with its LCP array and child table, which together stand in for a suffix tree.
+ *
+ * An lcp-interval l-[i..j] is a range of ranks whose suffixes share exactly l characters, i.e.
+ * an internal node of string depth l. It splits into child intervals at its l-indices, the ranks
+ * k in (i, j] with LCP[k] = l. The child table stores, in one int per rank, the first l-index of
+ * every interval and the next l-index after each one, so children are listed in O(1) each:
+ * search walks down from the root in O(m * alphabet) with no binary search, and a bottom-up
+ * pass visits every interval with one stack scan of the LCP array.
+ * The index refers to T and the suffix array rather than copying them, so both must outlive it.
+ */
+class EnhancedSarray
+{
+    public:
+        /**
+         * Builds the LCP array and child table of a suffix array of T.
+         *
+         * @param T The text the suffix array was built on [excluding '$']
+         * @param sarray The suffix array of T from build_sarray
+         */
+        EnhancedSarray(const std::string& T, const std::vector<int>& sarray);
+
+        /**
+         * Returns all positions of T where P occurs, in suffix array order, or {-1} if none.
+         */
+        std::vector<int> search(const std::string& P) const;
+
+        /**
+         * Returns the ranks [first, last) of the suffixes that start with P, found top-down.
+         */
+        std::pair<size_t, size_t> range(const std::string& P) const;
+
+        /**
+         * Calls visit(l, i, j) for every lcp-interval l-[i..j] with l > 0, children before parents.
+         */
+        void bottomUp(const std::function<void(int, size_t, size_t)>& visit) const;
+
+        /**
+         * Returns the longest substring occurring at least twice, or {0, 0, 0} if there is none.
+         */
+        Repeat longestRepeat() const;
+
+        /**
+         * Returns the maximal repeats of at least minLength characters, in no particular order:
+         * repeats whose occurrences cannot all be extended by the same character on either side.
+         */
+        std::vector<Repeat> maximalRepeats(int minLength = 1) const;
+
+        /**
+         * Returns the distinct substrings of exactly k characters occurring at least minCount
+         * times, in lexicographic order.
+         */
+        std::vector<Repeat> frequencies(int k, int minCount = 1) const;
+
+        /**
+         * Returns the LCP array (see build_lcp).
+         */
+        const std::vector<int>& lcp() const;
+
+    private:
+        /**
+         * Returns LCP[i], or -1 for the virtual bounds i = 0 and i = N.
+         */
+        int lcpAt(size_t i) const;
+
+        /**
+         * Returns the first l-index of the lcp-interval [i..j], where i < j.
+         */
+        size_t firstIndex(size_t i, size_t j) const;
+
+        /**
+         * Returns the l-index after k in the interval k belongs to, or 0 if k is its last one.
+         */
+        size_t nextIndex(size_t k) const;
+
+        /**
+         * Returns the character at offset d of the suffix at rank r, or -1 if the suffix is shorter.
+         */
+        int charAt(size_t r, size_t d) const;
+
+        const std::string& T;
+        const std::vector<int>& sarray;
+
+        // LCP[i]: LCP of the suffixes at ranks i - 1 and i
+        std::vector<int> LCP;
+
+        // child[i] is nextlIndex[i] if that exists, else down[i]; up[i] is kept in child[i - 1],
+        // which neither of the others uses whenever up[i] exists
+        std::vector<int> child;
+};
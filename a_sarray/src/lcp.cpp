@@ -0,0 +1,132 @@
+/**
+ * @file lcp.cpp
+ * Code to build the LCP array and search a suffix array with it.
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include "lcp.h"
+
+std::vector<int> build_lcp(const std::string& T, const std::vector<int>& sarray) {
+  long n = T.length();
+  long N = sarray.size();
+  std::vector<int> rank(N);
+  for (long i{0}; i < N; ++i)
+    rank[sarray[i]] = i;
+
+  // Suffix i + 1 shares at least h - 1 characters with its predecessor, so h drops by at most one per step
+  std::vector<int> LCP(N, 0);
+  long h = 0;
+  for (long i{0}; i < N; ++i) {
+    if (rank[i] == 0) {
+      h = 0;
+      continue;
+    }
+    long j = sarray[rank[i] - 1];
+    while (i + h < n && j + h < n && T[i + h] == T[j + h])
+      h++;
+    LCP[rank[i]] = h;
+    if (h > 0)
+      h--;
+  }
+
+  return LCP;
+}
+
+/**
+ * Returns how many leading characters a and b share, up to len.
+ * Equal blocks are skipped with memcmp, which is much faster than a byte loop on long matches.
+ */
+static long common_prefix(const char* a, const char* b, long len) {
+  long j = 0;
+  while (j + 64 <= len && std::memcmp(a + j, b + j, 64) == 0)
+    j += 64;
+  while (j < len && a[j] == b[j])
+    j++;
+  return j;
+}
+
+LcpIndex::LcpIndex(const std::string& T, const std::vector<int>& sarray)
+  : T(T), sarray(sarray), LCP(build_lcp(T, sarray)), Llcp(sarray.size()), Rlcp(sarray.size()) {
+  build(-1, sarray.size());
+}
+
+int LcpIndex::build(long lo, long hi) {
+  // Ranks -1 and N are virtual bounds that share nothing with any suffix
+  if (hi - lo == 1)
+    return hi < static_cast<long>(LCP.size()) ? LCP[hi] : 0;
+
+  long mid = lo + (hi - lo) / 2;
+  Llcp[mid] = build(lo, mid);
+  Rlcp[mid] = build(mid, hi);
+  return std::min(Llcp[mid], Rlcp[mid]);
+}
+
+size_t LcpIndex::firstRank(const std::string& P, bool strict) const {
+  long m = P.length();
+  long n = T.length();
+
+  // Invariant: suffixes at ranks <= lo come before the answer and those at >= hi do not;
+  // loLcp and hiLcp are how much of P the suffixes at lo and hi match
+  long lo = -1;
+  long hi = sarray.size();
+  long loLcp = 0;
+  long hiLcp = 0;
+  while (hi - lo > 1) {
+    long mid = lo + (hi - lo) / 2;
+
+    // Compare mid with the bound that matches more of P; if mid shares more with that
+    // bound than P does, it falls on the same side, and if less, on the other side
+    bool fromLo = loLcp >= hiLcp;
+    long known = fromLo ? loLcp : hiLcp;
+    long shared = fromLo ? Llcp[mid] : Rlcp[mid];
+    if (shared > known) {
+      (fromLo ? lo : hi) = mid;
+      continue;
+    }
+    if (shared < known) {
+      (fromLo ? hi : lo) = mid;
+      (fromLo ? hiLcp : loLcp) = shared;
+      continue;
+    }
+
+    // Otherwise resume comparing where the bound stopped matching
+    long pos = sarray[mid];
+    long j = known + common_prefix(T.data() + pos + known, P.data() + known, std::min(m, n - pos) - known);
+
+    bool before;
+    if (j == m)
+      before = strict;
+    else if (pos + j == n)
+      before = true;
+    else
+      before = static_cast<unsigned char>(T[pos + j]) < static_cast<unsigned char>(P[j]);
+
+    if (before) {
+      lo = mid;
+      loLcp = j;
+    } else {
+      hi = mid;
+      hiLcp = j;
+    }
+  }
+
+  return hi;
+}
+
+std::pair<size_t, size_t> LcpIndex::range(const std::string& P) const {
+  return {firstRank(P, false), firstRank(P, true)};
+}
+
+std::vector<int> LcpIndex::search(const std::string& P) const {
+  std::pair<size_t, size_t> r = range(P);
+  if (r.first == r.second)
+    return {-1};
+
+  return std::vector<int>(sarray.begin() + r.first, sarray.begin() + r.second);
+}
+
+const std::vector<int>& LcpIndex::lcp() const {
+  return LCP;
+}
@@ -0,0 +1,77 @@
+/**
+ * @file lcp.h
+ * Declarations of the LCP array and LCP-accelerated suffix array search (Manber & Myers).
+ */
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Returns the LCP array of a suffix array: entry i is the length of the longest common
+ * prefix of the suffixes at ranks i - 1 and i, and entry 0 is 0.
+ * Built with Kasai's algorithm in O(|T|) time.
+ *
+ * @param T The text the suffix array was built on [excluding '$']
+ * @param sarray The suffix array of T from build_sarray
+ */
+std::vector<int> build_lcp(const std::string& T, const std::vector<int>& sarray);
+
+/**
+ * A suffix array search that carries the LCP-LR arrays, so each step of the binary search
+ * resumes where earlier steps stopped matching and a query costs O(m + log n) comparisons.
+ * The index refers to T and the suffix array rather than copying them, so both must outlive it.
+ * Searches keep no state, so any number may run at once.
+ */
+class LcpIndex
+{
+    public:
+        /**
+         * Builds the LCP and LCP-LR arrays of a suffix array of T.
+         *
+         * @param T The text the suffix array was built on [excluding '$']
+         * @param sarray The suffix array of T from build_sarray
+         */
+        LcpIndex(const std::string& T, const std::vector<int>& sarray);
+
+        /**
+         * Returns all positions of T where P occurs, in suffix array order, or {-1} if none.
+         */
+        std::vector<int> search(const std::string& P) const;
+
+        /**
+         * Returns the ranks [first, last) of the suffixes that start with P.
+         */
+        std::pair<size_t, size_t> range(const std::string& P) const;
+
+        /**
+         * Returns the LCP array (see build_lcp).
+         */
+        const std::vector<int>& lcp() const;
+
+    private:
+        /**
+         * Fills Llcp and Rlcp for the search interval (lo, hi) and the ones nested in it.
+         * @return The LCP of the suffixes at ranks lo and hi (0 past either end)
+         */
+        int build(long lo, long hi);
+
+        /**
+         * Returns the first rank whose suffix, cut to |P| characters, is not smaller than P
+         * (or, if strict, is larger than P).
+         */
+        size_t firstRank(const std::string& P, bool strict) const;
+
+        const std::string& T;
+        const std::vector<int>& sarray;
+
+        // LCP[i]: LCP of the suffixes at ranks i - 1 and i
+        std::vector<int> LCP;
+
+        // For the search interval (lo, hi) split at mid: Llcp[mid] is the LCP of the
+        // suffixes at ranks lo and mid, and Rlcp[mid] that of ranks mid and hi
+        std::vector<int> Llcp;
+        std::vector<int> Rlcp;
+};
@@ -3,40 +3,100 @@
  * Code to using suffix arrays for exact pattern matching.
  */
 
-#include <iostream>
 #include <cmath>
 #include <cstdlib>
 #include <map>
 #include <algorithm>
+#include <limits>
+#include <string_view>
 
+#include "sais.h"
 #include "sarray.h"
 
 
+/**
+ * Builds the suffix array of T + '$' with SA-IS in O(|T|) time.
+ * Index is the signed type SA-IS works in and Out the element type handed back; they share
+ * a size, so SA-IS writes straight into the returned vector and no copy is made.
+ * Peak memory is the result plus a bit per character.
+ */
+template <typename Index, typename Out>
+static std::vector<Out> build_sarray_sais(const std::string& T) {
+  static_assert(sizeof(Index) == sizeof(Out), "SA-IS must write the output directly");
+  if (T.length() >= static_cast<size_t>(std::numeric_limits<Index>::max()))
+    return {};
+
+  Index n = static_cast<Index>(T.length()) + 1;
+  SentinelText<Index> text{reinterpret_cast<const unsigned char*>(T.data()), n - 1};
+
+  std::vector<Out> sarray(n);
+  sais(text, reinterpret_cast<Index*>(sarray.data()), n, Index{256});
+  return sarray;
+}
+
+
 /**
  * Returns the suffix array of T as an int vector.
  *
  * @param T A std::string object which holds the text being pre-processed.
  *
- * @return An std::vector<int> storing the suffix array
+ * @return An std::vector<int> storing the suffix array, or an empty vector if T is too long for int
  */
-std::vector<int> build_sarray(std::string T) {
-  // Create Unsorted Suffix Array Containing Strings
-  std::vector<std::string> sarray_string;
-  int pos = T.length();
-  for (unsigned long i{0}; i < T.length() + 1; i++) {
-    sarray_string.push_back(T.substr(pos, i) + '$');
-    pos--;
-  }
+std::vector<int> build_sarray(const std::string& T) {
+  return build_sarray_sais<int, int>(T);
+}
 
-  // Sort Suffix Array Containing Strings
-  std::sort(sarray_string.begin(), sarray_string.end());
-  
-  // Convert to Integer
-  std::vector<int> sarray;
-  for (auto element: sarray_string)
-    sarray.push_back(T.length() + 1 - element.size());
 
-  return sarray;
+/**
+ * Returns the suffix array of T with 32-bit indices.
+ *
+ * @param T The text; must be shorter than 2^31 - 1 characters
+ *
+ * @return The suffix array of T + '$', or an empty vector if T is too long
+ */
+std::vector<uint32_t> build_sarray32(const std::string& T) {
+  return build_sarray_sais<int32_t, uint32_t>(T);
+}
+
+
+/**
+ * Returns the suffix array of T with 64-bit indices.
+ *
+ * @param T The text, of any length
+ *
+ * @return The suffix array of T + '$'
+ */
+std::vector<uint64_t> build_sarray64(const std::string& T) {
+  return build_sarray_sais<int64_t, uint64_t>(T);
+}
+
+
+/**
+ * Compares the suffix of T at pos, cut to |P| characters, with P.
+ * Suffixes never need the '$': a suffix that runs out first compares smaller, as it would.
+ */
+static int compare_suffix(std::string_view P, std::string_view T, size_t pos) {
+  return T.substr(pos, P.length()).compare(P);
+}
+
+
+/**
+ * Returns the first rank in [0, size) whose suffix is not smaller than P
+ * (or, if strict, is larger than P when cut to |P| characters).
+ * Written out rather than std::partition_point, whose debug-mode checks scan the whole range.
+ */
+static size_t first_rank(std::string_view P, std::string_view T, const int* sarray, size_t size, bool strict) {
+  size_t lo = 0;
+  size_t hi = size;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    int cmp = compare_suffix(P, T, sarray[mid]);
+    if (cmp < 0 || (strict && cmp == 0))
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
 }
 
 
@@ -50,107 +110,50 @@ std::vector<int> build_sarray(std::string T) {
  * @return An std::vector<int> storing all matching index positions
  * NOTE: For full credit, you must use the suffix array
  */
-std::vector<int> sarray_search(std::string P, std::string T, std::vector<int> sarray) {
-  T = T+"$"; 
+std::vector<int> sarray_search(const std::string& P, const std::string& T, const std::vector<int>& sarray) {
+  return sarray_search(P, T, sarray.data(), sarray.size());
+}
 
-  std:: cout << T << std::endl;
-  std:: cout << P << std::endl;
 
+/**
+ * Returns all exact match locations of P, as above, for a suffix array held anywhere in memory.
+ *
+ * @param P The pattern being searched
+ * @param T The text the SA is built on [excluding '$']
+ * @param sarray The first of the suffix array's size entries
+ * @param size The number of entries, |T| + 1
+ */
+std::vector<int> sarray_search(std::string_view P, std::string_view T, const int* sarray, size_t size) {
   // Find the Smallest Index
-  int start_index = getSmallest(P, T, sarray);
-
-  // Find the Largest Index
-  int end_index = getLargest(P, T, sarray);
+  size_t start_index = first_rank(P, T, sarray, size, false);
 
-  // If Index are both -1 Return {-1}
-  if (start_index == -1 && end_index == -1)
+  // If No Suffix Starts With P, There is No Match
+  if (start_index == size || compare_suffix(P, T, sarray[start_index]) != 0)
     return {-1};
-  
-  // Return Values in that Range
-  std::vector<int> outList;
-  
-  outList.assign(sarray.begin() + start_index, sarray.begin() + end_index + 1);
-  return outList; 
-}
-
-int _getSmallest(std::string P, std::vector<std::string> s, std::string T, int low, int high) {
-  // Remember Last Match Index
-  static int index = -1;
-
-  // Base Case: Low > High
-  if (low > high || low == static_cast<int>(T.length()))
-    return index;
 
-  // Recursive Checks
-  int midpoint = (low + high) / 2;
-  int compare_value = (s.at(midpoint)).compare(0, P.size(), P);
-  if (compare_value == 0) {
-    index = midpoint;
+  // Find the Index After the Largest
+  size_t end_index = first_rank(P, T, sarray, size, true);
 
-    // Assume there is a smaller index
-    _getSmallest(P, s, T, low, midpoint - 1);
-  }
-  // P is Right Side
-  else if (compare_value < 0) {
-    _getSmallest(P, s, T, midpoint + 1, high);
-  }
-  // P is Left Side
-  else {
-    _getSmallest(P, s, T, low, midpoint - 1);
-  }
-
-  return index; 
+  // Return Values in that Range
+  return std::vector<int>(sarray + start_index, sarray + end_index);
 }
 
+
 // Binary Search for P in T, Assuming Query is Smaller on Match
-int getSmallest(std::string P, std::string T, std::vector<int> sarray) {
-  // Reconstruct String Suffix Array
-  std::vector<std::string> sarray_string;
-  for (unsigned long i{0}; i < T.length(); i++) {
-    sarray_string.push_back(T.substr(sarray.at(i)));
-  }
+int getSmallest(const std::string& P, const std::string& T, const std::vector<int>& sarray) {
+  size_t rank = first_rank(P, T, sarray.data(), sarray.size(), false);
+  if (rank == sarray.size() || compare_suffix(P, T, sarray[rank]) != 0)
+    return -1;
 
-  // Use Smallest Binary Search Helper
-  return _getSmallest(P, sarray_string, T, 0, sarray_string.size());
+  return rank;
 }
 
-int _getLargest(std::string P, std::vector<std::string> s, std::string T, int low, int high) {
-  // Remember Last Match Index
-  static int index = -1;
-
-  // Base Case: Low > High
-  if (low > high || low == static_cast<int>(T.length()))
-    return index;
-
-  // Recursive Checks
-  int midpoint = (low + high) / 2;
-  int compare_value = (s.at(midpoint)).compare(0, P.size(), P);
-  if (compare_value == 0) {
-    index = midpoint;
-
-    // Assume there is a smaller index
-    _getLargest(P, s, T, midpoint + 1, high);
-  }
-  // P is Right Side
-  else if (compare_value < 0) {
-    _getLargest(P, s, T, midpoint + 1, high);
-  }
-  // P is Left Side
-  else {
-    _getLargest(P, s, T, low, midpoint - 1);
-  }
-
-  return index; 
-}
 
 // Binary Search for P in T, Assuming Query is Larger on Match
-int getLargest(std::string P, std::string T, std::vector<int> sarray) {
-  // Reconstruct String Suffix Array
-  std::vector<std::string> sarray_string;
-  for (unsigned long i{0}; i < T.length(); i++) {
-    sarray_string.push_back(T.substr(sarray.at(i)));
-  }
+int getLargest(const std::string& P, const std::string& T, const std::vector<int>& sarray) {
+  size_t rank = first_rank(P, T, sarray.data(), sarray.size(), true);
+  if (rank == 0 || compare_suffix(P, T, sarray[rank - 1]) != 0)
+    return -1;
 
-  // Use Largest Binary Search Helper
-  return _getLargest(P, sarray_string, T, 0, sarray_string.size());
-}
\ No newline at end of file
+  return rank - 1;
+}
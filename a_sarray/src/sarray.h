@@ -5,15 +5,25 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <map>
 
 // Your assignment is to build these two functions
-std::vector<int> build_sarray(std::string T);
-std::vector<int> sarray_search(std::string P, std::string T, std::vector<int> sarray);
+std::vector<int> build_sarray(const std::string& T);
+std::vector<int> sarray_search(const std::string& P, const std::string& T, const std::vector<int>& sarray);
+
+// The same search over a suffix array held outside a vector, such as a memory-mapped SarrayFile
+std::vector<int> sarray_search(std::string_view P, std::string_view T, const int* sarray, size_t size);
+
+// Linear-time construction with unsigned indices, for texts too large for int
+std::vector<uint32_t> build_sarray32(const std::string& T);
+std::vector<uint64_t> build_sarray64(const std::string& T);
 
 // If you want to implement the two binary search method, these may be helpful!
 // THESE ARE OPTIONAL FUNCTIONS THAT WONT BE TESTED DIRECTLY
-int getSmallest(std::string P, std::string T, std::vector<int> sarray);
-int getLargest(std::string P, std::string T, std::vector<int> sarray);
\ No newline at end of file
+// The searches read P, T and sarray in place and keep no state, so any number may run at once
+int getSmallest(const std::string& P, const std::string& T, const std::vector<int>& sarray);
+int getLargest(const std::string& P, const std::string& T, const std::vector<int>& sarray);
\ No newline at end of file
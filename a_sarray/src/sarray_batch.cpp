@@ -0,0 +1,112 @@
+/**
+ * @file sarray_batch.cpp
+ * Code to search a suffix array for many patterns at once.
+ */
+
+#include <algorithm>
+#include <functional>
+#include <string_view>
+#include <thread>
+
+#include "sarray_batch.h"
+
+typedef std::pair<size_t, size_t> Range;
+
+/**
+ * Returns whether the suffix at pos, cut to |P| characters, sorts before P (or, if strict, not after it).
+ */
+static bool before(const std::string& P, const std::string& T, size_t pos, bool strict) {
+  int cmp = std::string_view(T).substr(pos, P.length()).compare(P);
+  return cmp < 0 || (strict && cmp == 0);
+}
+
+/**
+ * Returns the first rank at or after from whose suffix is not before P, given that none before from is.
+ * Steps double from from until one overshoots, so the cost is logarithmic in the distance moved.
+ * Written out rather than std::partition_point, whose debug-mode checks scan the whole range.
+ */
+static size_t gallop(const std::string& P, const std::string& T, const std::vector<int>& sarray,
+                     size_t from, bool strict) {
+  size_t lo = from;
+  size_t hi = from;
+  for (size_t step{1}; hi < sarray.size() && before(P, T, sarray[hi], strict); step *= 2) {
+    lo = hi + 1;
+    hi = std::min(sarray.size(), hi + step);
+  }
+
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (before(P, T, sarray[mid], strict))
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+/**
+ * Searches the sorted queries order[begin, end) and writes each result to out at the query's own index.
+ */
+static void search_sorted(const std::vector<std::string>& patterns, const std::vector<size_t>& order,
+                          size_t begin, size_t end, const std::string& T, const std::vector<int>& sarray,
+                          std::vector<Range>& out) {
+  // Interval starts only move forward through sorted queries, and so do the ends except
+  // where a query extends the one before it, whose interval then encloses its own.
+  // Each search resumes from the previous one; queries sharing a long prefix land close together
+  Range prev = {0, 0};
+  for (size_t q{begin}; q < end; ++q) {
+    const std::string& P = patterns[order[q]];
+    const std::string* prevP = q > begin ? &patterns[order[q - 1]] : nullptr;
+    if (prevP && P == *prevP) {
+      out[order[q]] = out[order[q - 1]];
+      continue;
+    }
+
+    bool extends = prevP && P.compare(0, prevP->length(), *prevP) == 0;
+    size_t first = gallop(P, T, sarray, prev.first, false);
+    size_t last = gallop(P, T, sarray, extends ? first : std::max(first, prev.second), true);
+    prev = {first, last};
+    out[order[q]] = first < last ? prev : Range{0, 0};
+  }
+}
+
+std::vector<Range> sarray_range_batch(const std::vector<std::string>& patterns,
+    const std::string& T, const std::vector<int>& sarray, unsigned threads) {
+  std::vector<size_t> order(patterns.size());
+  for (size_t i{0}; i < order.size(); ++i)
+    order[i] = i;
+  std::sort(order.begin(), order.end(), [&patterns](size_t a, size_t b) { return patterns[a] < patterns[b]; });
+
+  if (threads == 0)
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  threads = std::max<size_t>(1, std::min<size_t>(threads, order.size()));
+
+  // Contiguous pieces of the sorted order keep most shared prefixes within one thread
+  std::vector<Range> out(patterns.size());
+  std::vector<std::thread> workers;
+  size_t piece = (order.size() + threads - 1) / threads;
+  for (size_t begin{0}; begin < order.size(); begin += piece) {
+    size_t end = std::min(begin + piece, order.size());
+    workers.emplace_back(search_sorted, std::cref(patterns), std::cref(order), begin, end,
+                         std::cref(T), std::cref(sarray), std::ref(out));
+  }
+  for (std::thread& worker : workers)
+    worker.join();
+
+  return out;
+}
+
+std::vector<std::vector<int>> sarray_search_batch(const std::vector<std::string>& patterns,
+    const std::string& T, const std::vector<int>& sarray, unsigned threads) {
+  std::vector<Range> ranges = sarray_range_batch(patterns, T, sarray, threads);
+
+  std::vector<std::vector<int>> out;
+  out.reserve(ranges.size());
+  for (const Range& r : ranges) {
+    if (r.first == r.second)
+      out.push_back({-1});
+    else
+      out.emplace_back(sarray.begin() + r.first, sarray.begin() + r.second);
+  }
+  return out;
+}
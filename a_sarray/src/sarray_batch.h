@@ -0,0 +1,32 @@
+/**
+ * @file sarray_batch.h
+ * Declarations of batched suffix array search, which shares work between neighbouring queries.
+ */
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Returns, for every pattern, the ranks [first, last) of the suffixes of T that start with it,
+ * in the order the patterns were given.
+ * The patterns are sorted so each search starts from the SA interval of the one before,
+ * which queries with a shared prefix lie close to; the sorted batch is split into
+ * contiguous pieces, one per thread.
+ *
+ * @param patterns The queries
+ * @param T The text the suffix array was built on [excluding '$']
+ * @param sarray The suffix array of T from build_sarray
+ * @param threads How many threads to use; 0 uses one per hardware thread
+ */
+std::vector<std::pair<size_t, size_t>> sarray_range_batch(const std::vector<std::string>& patterns,
+    const std::string& T, const std::vector<int>& sarray, unsigned threads = 0);
+
+/**
+ * Returns, for every pattern, what sarray_search would: its positions in suffix array order, or {-1}.
+ * See sarray_range_batch.
+ */
+std::vector<std::vector<int>> sarray_search_batch(const std::vector<std::string>& patterns,
+    const std::string& T, const std::vector<int>& sarray, unsigned threads = 0);
@@ -0,0 +1,166 @@
+/**
+ * @file sarray_file.cpp
+ * Code to write suffix array index files and map them back.
+ */
+
+#include <climits>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "sarray.h"
+#include "sarray_file.h"
+
+/**
+ * Returns the 64-bit FNV-1a hash of the header fields before the checksum.
+ */
+static uint64_t header_checksum(const SarrayFileHeader& header) {
+  const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&header);
+  uint64_t hash = 14695981039346656037ULL;
+  for (size_t i{0}; i < offsetof(SarrayFileHeader, checksum); ++i) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+// Rounds offset up to the next section boundary
+static uint64_t align_section(uint64_t offset) {
+  return (offset + SARRAY_FILE_ALIGN - 1) / SARRAY_FILE_ALIGN * SARRAY_FILE_ALIGN;
+}
+
+// Writes zero bytes until the stream reaches offset
+static void pad_to(std::ofstream& out, uint64_t offset) {
+  static const char zeros[SARRAY_FILE_ALIGN] = {0};
+  uint64_t at = out.tellp();
+  out.write(zeros, offset - at);
+}
+
+bool SarrayFile::write(const std::string& path, const std::string& T, const std::vector<int>& sarray,
+                       const std::vector<int>* lcp) {
+  uint64_t entries = T.length() + 1;
+  if (sarray.size() != entries || (lcp && lcp->size() != entries))
+    return false;
+
+  SarrayFileHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, SARRAY_FILE_MAGIC, sizeof(header.magic));
+  header.version = SARRAY_FILE_VERSION;
+  header.byteOrder = SARRAY_FILE_BYTE_ORDER;
+  header.indexBytes = sizeof(int);
+  header.flags = lcp ? SARRAY_FILE_HAS_LCP : 0;
+  header.textLength = T.length();
+  header.textOffset = align_section(sizeof(header));
+  header.sarrayOffset = align_section(header.textOffset + T.length());
+  header.lcpOffset = lcp ? align_section(header.sarrayOffset + entries * sizeof(int)) : 0;
+  header.checksum = header_checksum(header);
+
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  pad_to(out, header.textOffset);
+  out.write(T.data(), T.length());
+  pad_to(out, header.sarrayOffset);
+  out.write(reinterpret_cast<const char*>(sarray.data()), entries * sizeof(int));
+  if (lcp) {
+    pad_to(out, header.lcpOffset);
+    out.write(reinterpret_cast<const char*>(lcp->data()), entries * sizeof(int));
+  }
+
+  return static_cast<bool>(out);
+}
+
+SarrayFile::~SarrayFile() {
+  close();
+}
+
+/**
+ * Returns whether a section of entries * width bytes at offset is aligned and inside a file of size bytes.
+ */
+static bool section_fits(uint64_t offset, uint64_t entries, uint64_t width, uint64_t size) {
+  return offset % SARRAY_FILE_ALIGN == 0 && offset >= sizeof(SarrayFileHeader) && offset <= size &&
+         entries <= (size - offset) / width;
+}
+
+bool SarrayFile::open(const std::string& path) {
+  close();
+
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+  struct stat info;
+  if (fstat(fd, &info) != 0 || static_cast<uint64_t>(info.st_size) < sizeof(SarrayFileHeader)) {
+    ::close(fd);
+    return false;
+  }
+
+  // The mapping stays valid after the descriptor is closed
+  size_t bytes = info.st_size;
+  void* mapped = mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (mapped == MAP_FAILED)
+    return false;
+  base = static_cast<const char*>(mapped);
+  mappedBytes = bytes;
+  header = reinterpret_cast<const SarrayFileHeader*>(base);
+
+  // Only the header is checked; the sections are used exactly as they were written
+  const SarrayFileHeader& h = *header;
+  uint64_t entries = h.textLength + 1;
+  bool valid = std::memcmp(h.magic, SARRAY_FILE_MAGIC, sizeof(h.magic)) == 0 &&
+               h.version == SARRAY_FILE_VERSION && h.byteOrder == SARRAY_FILE_BYTE_ORDER &&
+               h.indexBytes == sizeof(int) && h.checksum == header_checksum(h) &&
+               h.textLength < static_cast<uint64_t>(INT_MAX) &&
+               section_fits(h.textOffset, h.textLength, 1, bytes) &&
+               section_fits(h.sarrayOffset, entries, sizeof(int), bytes) &&
+               ((h.flags & SARRAY_FILE_HAS_LCP) ? section_fits(h.lcpOffset, entries, sizeof(int), bytes)
+                                               : h.lcpOffset == 0);
+  if (!valid) {
+    close();
+    return false;
+  }
+
+  return true;
+}
+
+void SarrayFile::close() {
+  if (base)
+    munmap(const_cast<char*>(base), mappedBytes);
+  base = nullptr;
+  mappedBytes = 0;
+  header = nullptr;
+}
+
+bool SarrayFile::isOpen() const {
+  return base != nullptr;
+}
+
+std::string_view SarrayFile::text() const {
+  if (!header)
+    return {};
+  return std::string_view(base + header->textOffset, header->textLength);
+}
+
+const int* SarrayFile::sarray() const {
+  return header ? reinterpret_cast<const int*>(base + header->sarrayOffset) : nullptr;
+}
+
+const int* SarrayFile::lcp() const {
+  if (!header || !(header->flags & SARRAY_FILE_HAS_LCP))
+    return nullptr;
+  return reinterpret_cast<const int*>(base + header->lcpOffset);
+}
+
+size_t SarrayFile::size() const {
+  return header ? header->textLength + 1 : 0;
+}
+
+std::vector<int> SarrayFile::search(std::string_view P) const {
+  if (!header)
+    return {-1};
+  return sarray_search(P, text(), sarray(), size());
+}
@@ -0,0 +1,102 @@
+/**
+ * @file sarray_file.h
+ * Declarations of an on-disk suffix array index that is memory-mapped rather than loaded.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * The first 64 bytes of an index file. The text, suffix array and optional LCP array follow
+ * in sections aligned to SARRAY_FILE_ALIGN bytes, stored as in memory: chars and native ints.
+ */
+struct SarrayFileHeader
+{
+  char magic[8];         // SARRAY_FILE_MAGIC
+  uint32_t version;      // SARRAY_FILE_VERSION
+  uint32_t byteOrder;    // SARRAY_FILE_BYTE_ORDER as written by the machine that built the file
+  uint32_t indexBytes;   // sizeof(int)
+  uint32_t flags;        // SARRAY_FILE_HAS_LCP if the LCP section is present
+  uint64_t textLength;   // |T|; the SA and LCP sections hold |T| + 1 entries
+  uint64_t textOffset;   // Byte offsets of the sections from the start of the file
+  uint64_t sarrayOffset;
+  uint64_t lcpOffset;    // 0 without an LCP section
+  uint64_t checksum;     // FNV-1a of the bytes above
+};
+
+static_assert(sizeof(SarrayFileHeader) == 64, "the header layout is part of the file format");
+
+const char SARRAY_FILE_MAGIC[8] = {'S', 'A', 'R', 'R', 'A', 'Y', '\0', '\0'};
+const uint32_t SARRAY_FILE_VERSION = 1;
+const uint32_t SARRAY_FILE_BYTE_ORDER = 0x01020304;
+const uint32_t SARRAY_FILE_HAS_LCP = 1;
+const uint64_t SARRAY_FILE_ALIGN = 64;
+
+/**
+ * A read-only suffix array index backed by a memory-mapped file.
+ * open() validates the header and maps the file; the text, suffix array and LCP array are then
+ * read in place, so opening costs the same for any text size and pages load as searches touch them.
+ * Searches keep no state, so any number may run at once.
+ */
+class SarrayFile
+{
+    public:
+        /**
+         * Writes an index file for T.
+         *
+         * @param path The file to create or replace
+         * @param T The text the suffix array was built on [excluding '$']
+         * @param sarray The suffix array of T from build_sarray
+         * @param lcp The LCP array from build_lcp, or nullptr to leave it out
+         * @return false if the arrays do not fit T or the file could not be written
+         */
+        static bool write(const std::string& path, const std::string& T, const std::vector<int>& sarray,
+                          const std::vector<int>* lcp = nullptr);
+
+        SarrayFile() = default;
+        SarrayFile(const SarrayFile&) = delete;
+        SarrayFile& operator=(const SarrayFile&) = delete;
+        ~SarrayFile();
+
+        /**
+         * Maps an index file, replacing any file open before.
+         *
+         * @return false if the file is missing, truncated, from another version or machine type,
+         *         or its header checksum does not match
+         */
+        bool open(const std::string& path);
+
+        /**
+         * Unmaps the file; does nothing if none is open.
+         */
+        void close();
+
+        // Returns true while a file is mapped
+        bool isOpen() const;
+
+        // Returns the mapped text [excluding '$']
+        std::string_view text() const;
+
+        // Returns the mapped suffix array, of size() entries
+        const int* sarray() const;
+
+        // Returns the mapped LCP array, of size() entries, or nullptr if the file has none
+        const int* lcp() const;
+
+        // Returns the number of suffix array entries, |T| + 1 (0 if no file is open)
+        size_t size() const;
+
+        /**
+         * Returns what sarray_search would for the mapped text and suffix array.
+         */
+        std::vector<int> search(std::string_view P) const;
+
+    private:
+        const char* base = nullptr;
+        size_t mappedBytes = 0;
+        const SarrayFileHeader* header = nullptr;
+};
@@ -0,0 +1,155 @@
+/**
+ * @file sarray_parallel.cpp
+ * Code to build suffix arrays by parallel prefix doubling.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <functional>
+#include <thread>
+
+#include "sarray_parallel.h"
+
+// Suffix array entries per unit of work handed to a thread
+const size_t PARALLEL_SA_CHUNK = 1 << 16;
+
+// Initial buckets: two symbols, each a byte + 1 or 0 for the sentinel
+const size_t PARALLEL_SA_BUCKETS = 257 * 257;
+
+/**
+ * Runs fn(thread) on threads threads and waits for all of them.
+ */
+static void run_threads(unsigned threads, const std::function<void(unsigned)>& fn) {
+  std::vector<std::thread> workers;
+  for (unsigned t{1}; t < threads; ++t)
+    workers.emplace_back(fn, t);
+  fn(0);
+  for (std::thread& worker : workers)
+    worker.join();
+}
+
+/**
+ * Runs fn(begin, end) over [0, n) in chunks of PARALLEL_SA_CHUNK, handed out to threads as they finish.
+ */
+static void for_chunks(size_t n, unsigned threads, const std::function<void(size_t, size_t)>& fn) {
+  std::atomic<size_t> next{0};
+  run_threads(threads, [&](unsigned) {
+    for (size_t begin = next.fetch_add(PARALLEL_SA_CHUNK); begin < n; begin = next.fetch_add(PARALLEL_SA_CHUNK))
+      fn(begin, std::min(n, begin + PARALLEL_SA_CHUNK));
+  });
+}
+
+std::vector<int> build_sarray_parallel(const std::string& T, unsigned threads) {
+  if (T.length() >= static_cast<size_t>(INT_MAX))
+    return {};
+  if (threads == 0)
+    threads = std::max(1u, std::thread::hardware_concurrency());
+
+  const unsigned char* text = reinterpret_cast<const unsigned char*>(T.data());
+  size_t n = T.length();
+  size_t N = n + 1;
+  auto key = [text, n](size_t i) {
+    size_t first = i < n ? text[i] + 1 : 0;
+    size_t second = i + 1 < n ? text[i + 1] + 1 : 0;
+    return first * 257 + second;
+  };
+
+  // Counting sort by the first two symbols, each thread counting and placing its own slice of the text
+  std::vector<int> SA(N);
+  std::vector<int> rank(N);
+  std::vector<std::vector<size_t>> counts(threads, std::vector<size_t>(PARALLEL_SA_BUCKETS, 0));
+  auto slice = [N, threads](unsigned t) { return N * t / threads; };
+  run_threads(threads, [&](unsigned t) {
+    for (size_t i{slice(t)}; i < slice(t + 1); ++i)
+      counts[t][key(i)]++;
+  });
+
+  std::vector<size_t> bucketStart(PARALLEL_SA_BUCKETS);
+  size_t sum = 0;
+  for (size_t b{0}; b < PARALLEL_SA_BUCKETS; ++b) {
+    bucketStart[b] = sum;
+    for (unsigned t{0}; t < threads; ++t) {
+      size_t count = counts[t][b];
+      counts[t][b] = sum;
+      sum += count;
+    }
+  }
+
+  run_threads(threads, [&](unsigned t) {
+    for (size_t i{slice(t)}; i < slice(t + 1); ++i) {
+      size_t b = key(i);
+      SA[counts[t][b]++] = i;
+      rank[i] = bucketStart[b];
+    }
+  });
+  counts.clear();
+  counts.shrink_to_fit();
+
+  // head[j] is set where a group of suffixes sharing their first h characters starts;
+  // a suffix's rank is the start of its group
+  std::vector<unsigned char> head(N, 0);
+  std::vector<unsigned char> split(N, 0);
+  for_chunks(N, threads, [&](size_t begin, size_t end) {
+    for (size_t j{begin}; j < end; ++j)
+      head[j] = j == 0 || rank[SA[j]] != rank[SA[j - 1]];
+  });
+
+  // Calls fn(s, e) for every unsorted group [s, e) whose start lies in [begin, end)
+  auto forGroups = [&](size_t begin, size_t end, const std::function<void(size_t, size_t)>& fn) {
+    size_t s = begin;
+    while (s < end && !head[s])
+      s++;
+    while (s < end) {
+      size_t e = s + 1;
+      while (e < N && !head[e])
+        e++;
+      if (e - s > 1)
+        fn(s, e);
+      s = e;
+    }
+  };
+
+  for (size_t h{2}; h < N; h *= 2) {
+    // Sort each group by the rank h characters on, marking where that rank changes.
+    // Ranks are only read here, and a suffix in an unsorted group has at least h characters left
+    for_chunks(N, threads, [&](size_t begin, size_t end) {
+      forGroups(begin, end, [&](size_t s, size_t e) {
+        std::sort(SA.begin() + s, SA.begin() + e, [&rank, h](int a, int b) { return rank[a + h] < rank[b + h]; });
+        for (size_t j{s + 1}; j < e; ++j)
+          split[j] = rank[SA[j] + h] != rank[SA[j - 1] + h];
+      });
+    });
+
+    // Rank every suffix of a split group by the start of its new group
+    std::atomic<bool> unsorted{false};
+    for_chunks(N, threads, [&](size_t begin, size_t end) {
+      forGroups(begin, end, [&](size_t s, size_t e) {
+        size_t start = s;
+        for (size_t j{s}; j < e; ++j) {
+          if (split[j]) {
+            if (j - start > 1)
+              unsorted = true;
+            start = j;
+          }
+          rank[SA[j]] = start;
+        }
+        if (e - start > 1)
+          unsorted = true;
+      });
+    });
+
+    // Only now can the new group starts be published, as group lookups read head
+    for_chunks(N, threads, [&](size_t begin, size_t end) {
+      for (size_t j{begin}; j < end; ++j) {
+        head[j] |= split[j];
+        split[j] = 0;
+      }
+    });
+
+    if (!unsorted)
+      break;
+  }
+
+  return SA;
+}
@@ -0,0 +1,23 @@
+/**
+ * @file sarray_parallel.h
+ * Declarations of multi-threaded suffix array construction.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+/**
+ * Returns the suffix array of T, as build_sarray does, built on several threads by prefix doubling
+ * (Manber & Myers, with Larsson & Sadakane's refinement of only sorting unsorted groups).
+ * Suffixes are first bucketed by two characters with a parallel counting sort; every round then
+ * sorts each group of suffixes sharing a prefix by the rank h characters on, doubling h.
+ * Groups are independent, so threads take chunks of the suffix array from a shared counter.
+ * Work is O(n log n) per round; peak memory is about 10 bytes per character, twice the SA-IS path.
+ *
+ * @param T The text
+ * @param threads How many threads to use; 0 uses one per hardware thread
+ * @return The suffix array of T + '$', or an empty vector if T is too long for int
+ */
+std::vector<int> build_sarray_parallel(const std::string& T, unsigned threads = 0);
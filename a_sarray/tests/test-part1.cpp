@@ -4,8 +4,20 @@
 #include <iostream>
 #include <vector>
 #include <algorithm>
-
+#include <thread>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <set>
+
+#include "csa.h"
+#include "doc_index.h"
+#include "esa.h"
+#include "lcp.h"
 #include "sarray.h"
+#include "sarray_batch.h"
+#include "sarray_file.h"
+#include "sarray_parallel.h"
 
 
 /*
@@ -224,4 +236,543 @@ TEST_CASE("Sarray Search values are correct Public 4", "[weight=5]") {
   outList = sarray_search(P, T, sarray);
   matchArray(outList,ans);
 
-}
\ No newline at end of file
+}
+TEST_CASE("Sarray Search forgets the matches of earlier queries", "[weight=0]") {
+  std::string T = "banana";
+  std::vector<int> sarray = build_sarray(T);
+
+  matchArray(sarray_search("ana", T, sarray), {1, 3});
+  matchArray(sarray_search("xyz", T, sarray), {-1});
+  matchArray(sarray_search("na", T, sarray), {2, 4});
+  matchArray(sarray_search("c", T, sarray), {-1});
+}
+
+
+/*
+* Linear-time construction
+*/
+
+std::string randomText(size_t n, int sigma, unsigned seed){
+  std::string T;
+  for(size_t i = 0; i < n; ++i){
+    seed = seed * 1103515245 + 12345;
+    T += static_cast<char>('A' + (seed >> 16) % sigma);
+  }
+  return T;
+}
+
+// Sorts the suffixes of T + '$' directly, with '$' below every byte
+std::vector<int> referenceSarray(const std::string& T){
+  std::vector<int> sa(T.length() + 1);
+  for(size_t i = 0; i < sa.size(); ++i)
+    sa[i] = i;
+  std::sort(sa.begin(), sa.end(), [&T](int a, int b){
+    return T.compare(a, std::string::npos, T, b, std::string::npos) < 0;
+  });
+  return sa;
+}
+
+TEST_CASE("Sarray builds match sorted suffixes at every index width", "[weight=0]") {
+  std::vector<std::string> texts = {"", "A", "AAAAAAAAAA", "ABABABABABA", "mississippi"};
+  for(int sigma : {1, 2, 4, 26})
+    for(size_t n : {50UL, 1000UL, 20000UL})
+      texts.push_back(randomText(n, sigma, n + sigma));
+  texts.push_back(randomText(5000, 3, 7) + randomText(5000, 3, 7));
+  texts.push_back(std::string("a\0b\xff\x80$a\0b", 9));
+
+  for(const std::string& T : texts){
+    std::vector<int> ans = referenceSarray(T);
+    matchSarray(build_sarray(T), ans);
+
+    std::vector<uint32_t> sa32 = build_sarray32(T);
+    std::vector<uint64_t> sa64 = build_sarray64(T);
+    REQUIRE(std::equal(ans.begin(), ans.end(), sa32.begin(), sa32.end()));
+    REQUIRE(std::equal(ans.begin(), ans.end(), sa64.begin(), sa64.end()));
+  }
+}
+
+// Every occurrence of P in T, found without the suffix array
+std::vector<int> naiveMatches(const std::string& P, const std::string& T){
+  std::vector<int> out;
+  for(size_t i = T.find(P); i != std::string::npos; i = T.find(P, i + 1))
+    out.push_back(i);
+  if(out.empty())
+    out.push_back(-1);
+  return out;
+}
+
+TEST_CASE("Sarray Search matches a naive scan from many threads at once", "[weight=0]") {
+  std::string T = randomText(20000, 3, 11);
+  std::vector<int> sarray = build_sarray(T);
+
+  // Each thread checks its own queries; results are compared after joining
+  std::vector<std::thread> threads;
+  std::vector<int> failures(4, 0);
+  for(int k = 0; k < 4; ++k){
+    threads.emplace_back([&, k](){
+      for(int q = 0; q < 200; ++q){
+        size_t len = 1 + q % 9;
+        std::string P = q % 5 == 0 ? randomText(len, 4, q * 4 + k) : T.substr((q * 97 + k * 1009) % (T.length() - len), len);
+        std::vector<int> out = sarray_search(P, T, sarray);
+        std::sort(out.begin(), out.end());
+        if(out != naiveMatches(P, T))
+          failures[k]++;
+      }
+    });
+  }
+  for(std::thread& thread : threads)
+    thread.join();
+
+  for(int k = 0; k < 4; ++k)
+    REQUIRE(failures[k] == 0);
+}
+
+
+/*
+* LCP array and LCP-accelerated search
+*/
+
+TEST_CASE("build_lcp matches direct prefix comparisons", "[weight=0]") {
+  std::vector<std::string> texts = {"", "A", "AAAAAAAA", "banana", "mississippi", randomText(3000, 2, 5)};
+  for(const std::string& T : texts){
+    std::vector<int> sarray = build_sarray(T);
+    std::vector<int> lcp = build_lcp(T, sarray);
+    REQUIRE(lcp.size() == sarray.size());
+    REQUIRE(lcp[0] == 0);
+    for(size_t i = 1; i < sarray.size(); ++i){
+      int h = 0;
+      while(sarray[i - 1] + h < static_cast<int>(T.length()) && sarray[i] + h < static_cast<int>(T.length()) &&
+            T[sarray[i - 1] + h] == T[sarray[i] + h])
+        h++;
+      REQUIRE(lcp[i] == h);
+    }
+  }
+
+  matchSarray(build_lcp("banana", build_sarray("banana")), {0, 0, 1, 3, 0, 0, 2});
+}
+
+TEST_CASE("LcpIndex finds the same matches as sarray_search", "[weight=0]") {
+  for(int sigma : {1, 2, 4}){
+    std::string T = randomText(5000, sigma, sigma) + randomText(5000, sigma, sigma);
+    std::vector<int> sarray = build_sarray(T);
+    LcpIndex index(T, sarray);
+    REQUIRE(index.lcp() == build_lcp(T, sarray));
+
+    for(int q = 0; q < 300; ++q){
+      size_t len = 1 + q % 40;
+      std::string P = q % 3 == 0 ? randomText(len, sigma + 1, q) : T.substr((q * 7919) % (T.length() - len), len);
+      INFO("sigma = " + std::to_string(sigma) + ", P = " + P);
+      REQUIRE(index.search(P) == sarray_search(P, T, sarray));
+
+      std::vector<int> out = index.search(P);
+      std::sort(out.begin(), out.end());
+      REQUIRE(out == naiveMatches(P, T));
+    }
+  }
+
+  std::string T = "mississippi";
+  std::vector<int> sarray = build_sarray(T);
+  LcpIndex index(T, sarray);
+  REQUIRE(index.range("ssi") == std::make_pair(size_t{10}, size_t{12}));
+  REQUIRE(index.range("") == std::make_pair(size_t{0}, sarray.size()));
+  matchArray(index.search("issi"), {1, 4});
+  matchArray(index.search("pp"), {8});
+  matchArray(index.search("mississippis"), {-1});
+  matchArray(index.search("a"), {-1});
+  matchArray(index.search("z"), {-1});
+}
+
+
+/*
+* Batched search
+*/
+
+TEST_CASE("sarray_search_batch answers every query as sarray_search does, in order", "[weight=0]") {
+  std::string T = randomText(20000, 3, 3);
+  std::vector<int> sarray = build_sarray(T);
+
+  // Overlapping prefixes, duplicates, misses and the empty pattern
+  std::vector<std::string> patterns = {"", "A", "AB", "ABC", "ABCA", "ABC", "A", "D", "AD", "CCCCCCCCCCCCCCCC"};
+  for(int q = 0; q < 500; ++q){
+    size_t len = 1 + q % 12;
+    patterns.push_back(q % 4 == 0 ? randomText(len, 4, q) : T.substr((q * 131) % (T.length() - len), len));
+  }
+  patterns.push_back(T.substr(T.length() - 5));
+  patterns.push_back(T.substr(T.length() - 5) + "A");
+
+  for(unsigned threads : {1u, 3u, 1000u}){
+    std::vector<std::vector<int>> out = sarray_search_batch(patterns, T, sarray, threads);
+    REQUIRE(out.size() == patterns.size());
+    for(size_t q = 0; q < patterns.size(); ++q){
+      INFO("threads = " + std::to_string(threads) + ", P = " + patterns[q]);
+      REQUIRE(out[q] == sarray_search(patterns[q], T, sarray));
+    }
+  }
+
+  REQUIRE(sarray_search_batch({}, T, sarray).empty());
+}
+
+
+/*
+* Memory-mapped index files
+*/
+
+TEST_CASE("SarrayFile serves searches straight from the mapped file", "[weight=0]") {
+  const std::string path = "sarray_test.idx";
+  for(const std::string& T : {std::string(""), std::string("banana"), randomText(10000, 4, 9)}){
+    std::vector<int> sarray = build_sarray(T);
+    std::vector<int> lcp = build_lcp(T, sarray);
+
+    for(bool withLcp : {false, true}){
+      REQUIRE(SarrayFile::write(path, T, sarray, withLcp ? &lcp : nullptr));
+      SarrayFile file;
+      REQUIRE(file.open(path));
+      REQUIRE(file.isOpen());
+      REQUIRE(file.text() == T);
+      REQUIRE(file.size() == sarray.size());
+      REQUIRE(std::equal(sarray.begin(), sarray.end(), file.sarray()));
+      if(withLcp)
+        REQUIRE(std::equal(lcp.begin(), lcp.end(), file.lcp()));
+      else
+        REQUIRE(file.lcp() == nullptr);
+
+      // Sections are aligned in the mapping
+      REQUIRE(reinterpret_cast<uintptr_t>(file.sarray()) % SARRAY_FILE_ALIGN == 0);
+
+      for(const std::string& P : {std::string("a"), std::string("ana"), std::string("AC"), std::string("CAGT"), std::string("zz")})
+        REQUIRE(file.search(P) == sarray_search(P, T, sarray));
+    }
+  }
+
+  std::remove(path.c_str());
+}
+
+TEST_CASE("SarrayFile refuses missing, truncated and corrupted files", "[weight=0]") {
+  const std::string path = "sarray_test.idx";
+  std::string T = randomText(1000, 3, 4);
+  std::vector<int> sarray = build_sarray(T);
+  SarrayFile file;
+
+  std::remove(path.c_str());
+  REQUIRE_FALSE(file.open(path));
+  REQUIRE_FALSE(file.isOpen());
+  REQUIRE(file.search("A") == std::vector<int>{-1});
+  REQUIRE_FALSE(SarrayFile::write(path, T + "A", sarray));
+
+  REQUIRE(SarrayFile::write(path, T, sarray));
+  std::ifstream in(path, std::ios::binary);
+  std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  in.close();
+
+  auto rewrite = [&path](const std::string& contents){
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(contents.data(), contents.size());
+  };
+
+  // Every header byte is covered by the magic, the checksum or the checksum itself
+  for(size_t i = 0; i < sizeof(SarrayFileHeader); ++i){
+    std::string corrupted = bytes;
+    corrupted[i] ^= 0x10;
+    rewrite(corrupted);
+    INFO("flipped header byte " + std::to_string(i));
+    REQUIRE_FALSE(file.open(path));
+  }
+
+  rewrite(bytes.substr(0, bytes.size() - 1));
+  REQUIRE_FALSE(file.open(path));
+  rewrite(bytes.substr(0, 10));
+  REQUIRE_FALSE(file.open(path));
+
+  rewrite(bytes);
+  REQUIRE(file.open(path));
+  file.close();
+  REQUIRE_FALSE(file.isOpen());
+
+  std::remove(path.c_str());
+}
+
+
+/*
+* Parallel construction
+*/
+
+TEST_CASE("build_sarray_parallel matches build_sarray for any thread count", "[weight=0]") {
+  std::vector<std::string> texts = {"", "A", "AA", "AAAAAAAAAAAAAAAAAAAAAAAAAAA", "mississippi", "abracadabra"};
+  for(int sigma : {1, 2, 4, 26})
+    texts.push_back(randomText(30000 + sigma, sigma, sigma));
+  texts.push_back(randomText(20000, 4, 1) + randomText(20000, 4, 1) + randomText(20000, 4, 1));
+  texts.push_back(std::string("a\0b\xff\x80$a\0b", 9));
+
+  for(const std::string& T : texts){
+    std::vector<int> ans = build_sarray(T);
+    for(unsigned threads : {1u, 2u, 5u}){
+      INFO("|T| = " + std::to_string(T.length()) + ", threads = " + std::to_string(threads));
+      REQUIRE(build_sarray_parallel(T, threads) == ans);
+    }
+  }
+}
+
+
+/*
+* Compressed suffix array
+*/
+
+TEST_CASE("CompressedSarray counts, locates and extracts as the plain suffix array does", "[weight=0]") {
+  std::vector<std::string> texts = {"", "A", "banana", "mississippi"};
+  for(int sigma : {1, 2, 4, 26})
+    texts.push_back(randomText(1000, sigma, sigma + 40));
+  texts.push_back(std::string("a\0b\xff\x80$a\0b", 9));
+
+  for(const std::string& T : texts){
+    std::vector<int> sarray = build_sarray(T);
+    for(unsigned long rate : {1UL, 5UL, 64UL, 100000UL}){
+      CompressedSarray csa(T, sarray, rate);
+      REQUIRE(csa.length() == T.length());
+      INFO("|T| = " + std::to_string(T.length()) + ", rate = " + std::to_string(rate));
+
+      for(size_t q = 0; q < 40; ++q){
+        size_t len = 1 + q % 6;
+        std::string P = T.length() > len && q % 3 ? T.substr((q * 577) % (T.length() - len), len) : randomText(len, 5, q);
+        std::vector<int> ans = sarray_search(P, T, sarray);
+        REQUIRE(csa.locate(P) == ans);
+        REQUIRE(csa.count(P) == (ans[0] == -1 ? 0 : ans.size()));
+      }
+
+      for(size_t i = 0; i <= T.length(); i += 1 + T.length() / 7)
+        REQUIRE(csa.extract(i, 25) == T.substr(i, 25));
+      REQUIRE(csa.extract(T.length() + 3, 5) == "");
+    }
+  }
+
+  CompressedSarray wrong("banana", build_sarray("bananas"));
+  REQUIRE(wrong.count("a") == 0);
+  REQUIRE(wrong.locate("a") == std::vector<int>{-1});
+}
+
+TEST_CASE("CompressedSarray takes less memory than the text it indexes", "[weight=0]") {
+  std::string T = randomText(100000, 4, 3);
+  std::vector<int> sarray = build_sarray(T);
+
+  CompressedSarray csa(T, sarray);
+  INFO("bytes = " + std::to_string(csa.bytes()));
+  REQUIRE(csa.bytes() < T.length());
+
+  // Sparser samples save memory
+  REQUIRE(CompressedSarray(T, sarray, 256).bytes() < csa.bytes());
+  REQUIRE(CompressedSarray(T, sarray, 8).bytes() > csa.bytes());
+}
+
+
+/*
+* Document collections
+*/
+
+TEST_CASE("DocumentIndex finds every occurrence in every document", "[weight=0]") {
+  std::vector<std::string> docs = {"banana", "", "ananas", "nab", std::string("a\0na", 4), "bandana"};
+  for(int d = 0; d < 60; ++d)
+    docs.push_back(randomText(d * 7 % 90, 3, d));
+  DocumentIndex index(docs);
+  REQUIRE(index.documents() == docs.size());
+
+  std::vector<std::string> patterns = {"a", "an", "ana", "nab", "na", std::string("\0", 1), "ab", "ba", "zz", "ABC", "CCA", "AAAA", "banana" "ananas"};
+  for(const std::string& P : patterns){
+    INFO("P = " + P);
+    std::vector<std::pair<int, int>> expected;
+    std::vector<int> containing;
+    for(size_t d = 0; d < docs.size(); ++d){
+      for(size_t i = docs[d].find(P); i != std::string::npos; i = docs[d].find(P, i + 1))
+        expected.emplace_back(d, i);
+      if(docs[d].find(P) != std::string::npos)
+        containing.push_back(d);
+    }
+
+    std::vector<std::pair<int, int>> found = index.search(P);
+    std::sort(found.begin(), found.end());
+    REQUIRE(found == expected);
+
+    std::vector<int> listed = index.listDocuments(P);
+    std::sort(listed.begin(), listed.end());
+    REQUIRE(listed == containing);
+  }
+
+  // Matches never span two documents
+  REQUIRE(index.search("bananaan").empty());
+  REQUIRE(index.search("nabana").empty());
+  REQUIRE(DocumentIndex({}).listDocuments("a").empty());
+}
+
+TEST_CASE("DocumentIndex lists documents once each however often they match", "[weight=0]") {
+  // Thousands of occurrences in a few documents, and a block-crossing spread of single ones
+  std::vector<std::string> docs(500, "xyz");
+  docs[3] = std::string(5000, 'a');
+  docs[250] = std::string(3000, 'a');
+  for(size_t d = 0; d < docs.size(); d += 37)
+    docs[d] += "qa";
+
+  DocumentIndex index(docs);
+  std::vector<int> listed = index.listDocuments("a");
+  std::sort(listed.begin(), listed.end());
+
+  std::vector<int> expected = {3, 250};
+  for(size_t d = 0; d < docs.size(); d += 37)
+    expected.push_back(d);
+  std::sort(expected.begin(), expected.end());
+  expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+  REQUIRE(listed == expected);
+  REQUIRE(index.search("a").size() == 5000 + 3000 + expected.size() - 2);
+
+  // Many small documents over two letters spread each pattern across hundreds of RMQ blocks
+  std::vector<std::string> small;
+  for(int d = 0; d < 3000; ++d)
+    small.push_back(randomText(d % 41, 2, d));
+  DocumentIndex many(small);
+  for(int q = 0; q < 60; ++q){
+    std::string P = randomText(1 + q % 7, 2, 1000 + q);
+    std::vector<int> containing;
+    for(size_t d = 0; d < small.size(); ++d)
+      if(small[d].find(P) != std::string::npos)
+        containing.push_back(d);
+
+    std::vector<int> found = many.listDocuments(P);
+    std::sort(found.begin(), found.end());
+    INFO("P = " + P);
+    REQUIRE(found == containing);
+  }
+}
+
+
+/*
+* Enhanced suffix array
+*/
+
+TEST_CASE("EnhancedSarray walks top-down to the same matches as sarray_search", "[weight=0]") {
+  for(int sigma : {1, 2, 4, 26}){
+    std::string T = randomText(4000, sigma, sigma) + randomText(4000, sigma, sigma);
+    std::vector<int> sarray = build_sarray(T);
+    EnhancedSarray esa(T, sarray);
+    LcpIndex index(T, sarray);
+    REQUIRE(esa.lcp() == index.lcp());
+
+    for(int q = 0; q < 300; ++q){
+      size_t len = 1 + q % 40;
+      std::string P = q % 3 == 0 ? randomText(len, sigma + 1, q) : T.substr((q * 7919) % (T.length() - len), len);
+      INFO("sigma = " + std::to_string(sigma) + ", P = " + P);
+      REQUIRE(esa.search(P) == sarray_search(P, T, sarray));
+      if(esa.search(P)[0] != -1)
+        REQUIRE(esa.range(P) == index.range(P));
+    }
+  }
+
+  std::string T = "mississippi";
+  std::vector<int> sarray = build_sarray(T);
+  EnhancedSarray esa(T, sarray);
+  REQUIRE(esa.range("ssi") == std::make_pair(size_t{10}, size_t{12}));
+  REQUIRE(esa.range("") == std::make_pair(size_t{0}, sarray.size()));
+  matchArray(esa.search("issi"), {1, 4});
+  matchArray(esa.search("i"), {1, 4, 7, 10});
+  matchArray(esa.search("pp"), {8});
+  matchArray(esa.search("mississippi"), {0});
+  matchArray(esa.search("mississippis"), {-1});
+  matchArray(esa.search("ssippix"), {-1});
+  matchArray(esa.search("a"), {-1});
+  matchArray(esa.search("z"), {-1});
+
+  std::string empty = "";
+  std::vector<int> none = build_sarray(empty);
+  REQUIRE(EnhancedSarray(empty, none).search("a") == std::vector<int>{-1});
+}
+
+TEST_CASE("EnhancedSarray visits exactly the lcp-intervals, children first", "[weight=0]") {
+  for(int sigma : {1, 2, 3}){
+    std::string T = randomText(300, sigma, 10 + sigma);
+    std::vector<int> sarray = build_sarray(T);
+    EnhancedSarray esa(T, sarray);
+    const std::vector<int>& LCP = esa.lcp();
+    size_t N = sarray.size();
+
+    // l-[i..j] is an interval if l = min LCP(i..j] and the LCP drops below l just outside it
+    std::vector<std::vector<size_t>> expected;
+    for(size_t i = 0; i < N; ++i){
+      int l = INT32_MAX;
+      for(size_t j = i + 1; j < N; ++j){
+        l = std::min(l, LCP[j]);
+        if(l > 0 && (i == 0 || LCP[i] < l) && (j + 1 == N || LCP[j + 1] < l))
+          expected.push_back({size_t(l), i, j});
+      }
+    }
+
+    std::vector<std::vector<size_t>> visited;
+    esa.bottomUp([&](int l, size_t i, size_t j){
+      // Every interval already visited inside this one is deeper
+      for(const std::vector<size_t>& v : visited)
+        if(v[1] >= i && v[2] <= j)
+          REQUIRE(v[0] > size_t(l));
+      visited.push_back({size_t(l), i, j});
+    });
+
+    std::sort(expected.begin(), expected.end());
+    std::sort(visited.begin(), visited.end());
+    REQUIRE(visited == expected);
+  }
+}
+
+TEST_CASE("EnhancedSarray finds repeats and substring counts as a naive scan does", "[weight=0]") {
+  std::vector<std::string> texts = {"", "a", "aaaa", "abab", "mississippi", "xabcyabcwabcyz", "banana"};
+  for(int seed = 0; seed < 20; ++seed)
+    texts.push_back(randomText(20 + seed * 3, 2 + seed % 3, seed));
+
+  for(const std::string& T : texts){
+    INFO("T = " + T);
+    std::vector<int> sarray = build_sarray(T);
+    EnhancedSarray esa(T, sarray);
+    long n = T.length();
+
+    // Every substring occurring twice, counted, with its set of left and right neighbours
+    std::map<std::string, int> counts;
+    std::map<std::string, std::set<int>> left;
+    std::map<std::string, std::set<int>> right;
+    for(long i = 0; i < n; ++i){
+      for(long len = 1; i + len <= n; ++len){
+        std::string s = T.substr(i, len);
+        counts[s]++;
+        left[s].insert(i == 0 ? -1 - i : static_cast<unsigned char>(T[i - 1]));
+        right[s].insert(i + len == n ? -1 - i : static_cast<unsigned char>(T[i + len]));
+      }
+    }
+
+    size_t longest = 0;
+    std::set<std::pair<std::string, int>> maximal;
+    for(const auto& [s, count] : counts){
+      if(count < 2)
+        continue;
+      longest = std::max(longest, s.length());
+      if(left[s].size() > 1 && right[s].size() > 1)
+        maximal.insert({s, count});
+    }
+
+    Repeat best = esa.longestRepeat();
+    REQUIRE(size_t(best.length) == longest);
+    if(longest > 0)
+      REQUIRE(best.count == counts[T.substr(best.position, best.length)]);
+
+    std::set<std::pair<std::string, int>> found;
+    for(const Repeat& r : esa.maximalRepeats())
+      found.insert({T.substr(r.position, r.length), r.count});
+    REQUIRE(found == maximal);
+    for(const Repeat& r : esa.maximalRepeats(3))
+      REQUIRE(r.length >= 3);
+
+    for(int k : {1, 2, 3, 5}){
+      std::vector<std::pair<std::string, int>> expected;
+      for(const auto& [s, count] : counts)
+        if(s.length() == size_t(k) && count >= 2)
+          expected.push_back({s, count});
+
+      std::vector<std::pair<std::string, int>> table;
+      for(const Repeat& r : esa.frequencies(k, 2))
+        table.push_back({T.substr(r.position, r.length), r.count});
+      REQUIRE(table == expected);
+      REQUIRE(esa.frequencies(k).size() == size_t(std::count_if(counts.begin(), counts.end(), [&](const auto& e){ return e.first.length() == size_t(k); })));
+    }
+  }
+}
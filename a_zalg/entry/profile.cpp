@@ -0,0 +1,52 @@
+/**
+ * @file profile.cpp
+ * Renders comparison heatmaps of the Z-algorithm and Boyer-Moore on a text file.
+ *
+ * Usage: ./profile PATTERN TEXT_FILE [OUTPUT_PREFIX]
+ */
+
+#include <string>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include "zprofile.h"
+
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    std::cout << "Usage: " << argv[0] << " PATTERN TEXT_FILE [OUTPUT_PREFIX]" << std::endl;
+    return 1;
+  }
+
+  std::string P = argv[1];
+  std::string prefix = argc > 3 ? argv[3] : "profile";
+
+  std::ifstream file(argv[2], std::ios::binary);
+  if (!file) {
+    std::cout << "Could not open " << argv[2] << std::endl;
+    return 1;
+  }
+  std::stringstream buffer;
+  buffer << file.rdbuf();
+  std::string T = buffer.str();
+
+  // Z-algorithm run (over S = P$T)
+  cs225::Profiler zprof(T.length(), P.length() + 1);
+  std::vector<int> zmatches = zalg_profile(P, T, zprof);
+  bool zwritten = zprof.writePNG(prefix + "_zalg.png");
+
+  // Boyer-Moore run (over T)
+  cs225::Profiler bprof(T.length());
+  std::vector<int> bmatches = bmoore_profile(P, T, bprof);
+  bool bwritten = bprof.writePNG(prefix + "_bmoore.png");
+
+  std::cout << "Block size: " << zprof.getBlockSize() << " positions" << std::endl;
+  std::cout << "zalg:   " << zprof.getTotalComparisons() << " comparisons -> "
+            << (zwritten ? prefix + "_zalg.png" : "(could not write " + prefix + "_zalg.png)") << std::endl;
+  std::cout << "bmoore: " << bprof.getTotalComparisons() << " comparisons -> "
+            << (bwritten ? prefix + "_bmoore.png" : "(could not write " + prefix + "_bmoore.png)") << std::endl;
+  std::cout << "Matches: " << (zmatches.front() == -1 ? 0 : zmatches.size()) << std::endl;
+
+  return zwritten && bwritten ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,130 @@
+/**
+ * @file profiler.cpp
+ * Per-position comparison profiles rendered through lodepng.
+ *
+ */
+
+#include "profiler.h"
+#include "lodepng/lodepng.h"
+#include <algorithm>
+#include <cmath>
+
+namespace cs225 {
+  // Upper bound on blocks when the block size is picked automatically
+  static const long MAX_AUTO_BLOCKS = 4096;
+
+  // Track heights (in pixels) of the rendered image
+  static const unsigned HEAT_HEIGHT = 48;
+  static const unsigned TRACK_HEIGHT = 12;
+  static const unsigned GAP_HEIGHT = 2;
+
+  Profiler::Profiler(long length, long offset, long blockSize) {
+    this->length = std::max(0L, length);
+    this->offset = offset;
+
+    if (blockSize <= 0)
+      blockSize = std::max(1L, (this->length + MAX_AUTO_BLOCKS - 1) / MAX_AUTO_BLOCKS);
+    this->blockSize = blockSize;
+
+    long n = (this->length + blockSize - 1) / blockSize;
+    comps.assign(n, 0);
+    zbox.assign(n, 0);
+    skips.assign(n, 0);
+  }
+
+  long Profiler::blockOf(long pos) const {
+    pos -= offset;
+    if (pos < 0 || pos >= length)
+      return -1;
+    return pos / blockSize;
+  }
+
+  void Profiler::recordComparison(long pos) {
+    long b = blockOf(pos);
+    if (b >= 0)
+      comps[b]++;
+  }
+
+  void Profiler::recordZBox(long pos) {
+    long b = blockOf(pos);
+    if (b >= 0)
+      zbox[b]++;
+  }
+
+  void Profiler::recordSkip(long pos, long length) {
+    long b = blockOf(pos);
+    if (b >= 0)
+      skips[b] = std::max(skips[b], length);
+  }
+
+  long Profiler::blocks() const {
+    return comps.size();
+  }
+
+  long Profiler::getBlockSize() const {
+    return blockSize;
+  }
+
+  long Profiler::getComparisons(long block) const {
+    return comps.at(block);
+  }
+
+  long Profiler::getTotalComparisons() const {
+    long total = 0;
+    for (long c : comps)
+      total += c;
+    return total;
+  }
+
+  bool Profiler::writePNG(const std::string& filename, unsigned width) const {
+    long n = blocks();
+    if (n == 0)
+      return false;
+
+    // Never squeeze two blocks into one pixel column
+    unsigned perBlock = std::max(1u, width / static_cast<unsigned>(n));
+    unsigned w = perBlock * n;
+    unsigned h = HEAT_HEIGHT + GAP_HEIGHT + TRACK_HEIGHT + GAP_HEIGHT + TRACK_HEIGHT;
+    std::vector<unsigned char> image(4 * w * h, 0);
+
+    // Heat is log-scaled comparisons per position so hot spots stay visible
+    double maxHeat = 0;
+    long maxSkip = 1;
+    for (long b = 0; b < n; ++b) {
+      maxHeat = std::max(maxHeat, std::log1p(static_cast<double>(comps[b]) / blockSize));
+      maxSkip = std::max(maxSkip, skips[b]);
+    }
+    if (maxHeat == 0)
+      maxHeat = 1;
+
+    auto fill = [&](long b, unsigned y0, unsigned y1, double r, double g, double bl) {
+      for (unsigned y = y0; y < y1; ++y) {
+        for (unsigned x = b * perBlock; x < (b + 1) * perBlock; ++x) {
+          unsigned char* px = &image[4 * (y * w + x)];
+          px[0] = static_cast<unsigned char>(255 * r);
+          px[1] = static_cast<unsigned char>(255 * g);
+          px[2] = static_cast<unsigned char>(255 * bl);
+          px[3] = 255;
+        }
+      }
+    };
+
+    unsigned zTop = HEAT_HEIGHT + GAP_HEIGHT;
+    unsigned sTop = zTop + TRACK_HEIGHT + GAP_HEIGHT;
+    for (long b = 0; b < n; ++b) {
+      // Black -> red -> yellow -> white
+      double t = std::log1p(static_cast<double>(comps[b]) / blockSize) / maxHeat;
+      fill(b, 0, HEAT_HEIGHT, std::min(1.0, 3 * t), std::clamp(3 * t - 1, 0.0, 1.0), std::clamp(3 * t - 2, 0.0, 1.0));
+
+      // Fraction of the block covered by Z-boxes
+      long span = std::min(blockSize, length - b * blockSize);
+      fill(b, zTop, zTop + TRACK_HEIGHT, 0, std::min(1.0, static_cast<double>(zbox[b]) / span), 0);
+
+      // Longest skip made from the block
+      fill(b, sTop, sTop + TRACK_HEIGHT, 0, 0, static_cast<double>(skips[b]) / maxSkip);
+    }
+
+    return lodepng::encode(filename, image, w, h) == 0;
+  }
+
+}
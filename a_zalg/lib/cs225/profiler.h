@@ -0,0 +1,62 @@
+/**
+ * @file profiler.h
+ * Records where a string matcher spends its character comparisons
+ * and renders the result as a PNG heatmap.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace cs225 {
+  class Profiler {
+  public:
+    /**
+     * Creates a profile over positions [0, length) of a text.
+     *
+     * @param length The number of text positions being profiled
+     * @param offset Recorded positions are shifted down by offset (e.g. |P| + 1 for S = P$T)
+     * @param blockSize Positions per block (0 picks one so there are at most 4096 blocks)
+     */
+    Profiler(long length, long offset = 0, long blockSize = 0);
+
+    // Counts one character comparison at (unshifted) position pos
+    void recordComparison(long pos);
+
+    // Marks (unshifted) position pos as resolved inside a Z-box
+    void recordZBox(long pos);
+
+    // Records a shift of the given length made from alignment (unshifted) pos
+    void recordSkip(long pos, long length);
+
+    long blocks() const;
+    long getBlockSize() const;
+    long getComparisons(long block) const;
+    long getTotalComparisons() const;
+
+    /**
+     * Writes the profile as a PNG: a comparison heatmap on top,
+     * then a Z-box coverage track and a skip length track.
+     *
+     * @param filename The file to write
+     * @param width The image width in pixels (at least one pixel per block is used)
+     *
+     * @return True if the PNG was written
+     */
+    bool writePNG(const std::string& filename, unsigned width = 1024) const;
+
+  private:
+    long length;
+    long offset;
+    long blockSize;
+
+    std::vector<long> comps;
+    std::vector<long> zbox;
+    std::vector<long> skips;
+
+    // Returns the block holding (unshifted) position pos, or -1 if outside the text
+    long blockOf(long pos) const;
+  };
+
+}
@@ -5,7 +5,9 @@
  */
 
 #include "zstring.h"
+#include "profiler.h"
 #include <cmath>
+#include <algorithm>
 #include <iostream>
 
 namespace cs225 {
@@ -15,12 +17,15 @@ namespace cs225 {
     l = 0;
 
     charComps = 0;
+    profiler = nullptr;
 
     s = input;
   }
 
   bool zstring::charMatch(int i, int j){
     charComps++;
+    if (profiler)
+      profiler->recordComparison(std::max(i, j));
     return s[i]==s[j];
   }
 
@@ -32,6 +37,10 @@ namespace cs225 {
     return charComps;
   }
 
+  void zstring::setProfiler(Profiler* profiler){
+    this->profiler = profiler;
+  }
+
   void zstring::printCoords(){
     std::cout << "i, l, r: " << i << ", " << l << ", " << r << std::endl;
   }
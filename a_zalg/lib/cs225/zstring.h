@@ -10,6 +10,8 @@
 #include <string>
 
 namespace cs225 {
+  class Profiler;
+
   class zstring {
   public:
     int i; 
@@ -31,9 +33,13 @@ namespace cs225 {
 
     int getCharComps();
 
+    // Also report every comparison to profiler (nullptr to stop profiling)
+    void setProfiler(Profiler* profiler);
+
   private: 
     std::string s; 
     int charComps;
+    Profiler* profiler;
   };
 
 }
@@ -11,7 +11,7 @@
 #include "zalg.h"
 
 // Returns the Z value for given string, S, and position
-int compute_Z(std::string S, cs225::zstring& inS, int position, int offset) {
+int compute_Z(const std::string& S, cs225::zstring& inS, int position, int offset) {
   /* Pseudocode:
     * 1.) Compare character at position to first character in S 
       * a.) Continue until no match, tracking the number of comparisons
@@ -38,12 +38,14 @@ int compute_Z(std::string S, cs225::zstring& inS, int position, int offset) {
  *
  * @param S A std::string object which holds the String being analyzed.
  * @param Z An int* that points to a length |S| int[] which holds the zArray.
+ * @param profiler An optional cs225::Profiler that records comparisons and Z-box coverage per position.
  *
  * @return An integer counting the number of character comparisons needed to make the Z-array.
  */
-int create_zarray(std::string S, int* Z) {
+int create_zarray(std::string S, int* Z, cs225::Profiler* profiler) {
   // You need to track character comparisons. Here are two suggested ways: 
   cs225::zstring inS(S); //Use 'cs225::zstring' to automatically track comparisons
+  inS.setProfiler(profiler);
 
   // Skip First Position in Z
   *Z = 0;
@@ -60,6 +62,9 @@ int create_zarray(std::string S, int* Z) {
     }
     // Case #2: i <= r
     else if (inS.i <= inS.r) {
+      if (profiler)
+        profiler->recordZBox(inS.i);
+
       // Compute |B| and k
       B = inS.r - inS.i + 1;
       k = inS.i - inS.l;
@@ -123,13 +128,13 @@ std::vector<int> zalg_search(std::string P, std::string T) {
     }
   }
 
+  delete[] zarr; // No memory leaks here!
+
   // The vector can check if it is currently empty
   if (outList.empty()) {
     outList.push_back(-1);
     return outList;
   }
 
-  delete[] zarr; // No memory leaks here!
-
   return outList;
 }
\ No newline at end of file
@@ -8,7 +8,8 @@
 #include <string>
 #include <vector>
 #include "cs225/zstring.h"
+#include "cs225/profiler.h"
 
-int compute_Z(std::string S, cs225::zstring& inS, int position, int offset);
-int create_zarray(std::string S, int* Z);
+int compute_Z(const std::string& S, cs225::zstring& inS, int position, int offset);
+int create_zarray(std::string S, int* Z, cs225::Profiler* profiler = nullptr);
 std::vector<int> zalg_search(std::string P, std::string T);
\ No newline at end of file
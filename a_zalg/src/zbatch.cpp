@@ -0,0 +1,190 @@
+/**
+ * @file zbatch.cpp
+ * Code to compute the Z-arrays of many short strings at once.
+ *
+ * Strings are grouped into blocks of ZBATCH_LANES and transposed so that
+ * character p of every string in a block sits in one contiguous row.
+ * Every lane then runs the Z-algorithm in lockstep, which lets the compiler
+ * turn the inner loops over lanes into vector instructions.
+ */
+
+#include <algorithm>
+#include <numeric>
+#include <thread>
+
+#include "zbatch.h"
+
+namespace {
+
+// Padding symbol for transposed rows; never equal to a real character
+const unsigned short ZBATCH_PAD = 256;
+
+/**
+ * Computes the Z-arrays of up to ZBATCH_LANES strings in lockstep.
+ *
+ * @param S The full batch of strings
+ * @param ids The indices (into S) of the strings in this block
+ * @param count The number of valid entries in ids
+ * @param out The batch whose arenas receive the Z-values
+ */
+void zarray_block(const std::vector<std::string>& S, const size_t* ids, int count, ZBatch& out) {
+  const int W = ZBATCH_LANES;
+
+  // Lane lengths (unused lanes have length 0)
+  int len[W];
+  int maxlen = 0;
+  for (int lane{0}; lane < W; ++lane) {
+    len[lane] = lane < count ? static_cast<int>(S[ids[lane]].length()) : 0;
+    maxlen = std::max(maxlen, len[lane]);
+  }
+
+  // Transpose the block; one extra padding row stops every extension
+  std::vector<unsigned short> T(static_cast<size_t>(maxlen + 1) * W, ZBATCH_PAD);
+  for (int lane{0}; lane < count; ++lane) {
+    const std::string& s = S[ids[lane]];
+    for (int p{0}; p < len[lane]; ++p)
+      T[static_cast<size_t>(p) * W + lane] = static_cast<unsigned char>(s[p]);
+  }
+
+  std::vector<int> Z(static_cast<size_t>(maxlen) * W, 0);
+
+  // Z-box [l, r) of every lane
+  int l[W] = {0};
+  int r[W] = {0};
+  int z[W];
+  int active[W];
+
+  for (int i{1}; i < maxlen; ++i) {
+    // Case #1 / #2: start from the Z-box copy where one is available
+    for (int lane{0}; lane < W; ++lane) {
+      int inBox = i < r[lane];
+      int zk = Z[static_cast<size_t>(i - l[lane]) * W + lane];
+      int B = r[lane] - i;
+      z[lane] = inBox ? std::min(zk, B) : 0;
+      active[lane] = (i < len[lane]) & (!inBox | (zk == B));
+    }
+
+    // Extend every unresolved lane one character at a time
+    int any = 1;
+    while (any) {
+      any = 0;
+      for (int lane{0}; lane < W; ++lane) {
+        int eq = active[lane] & (T[static_cast<size_t>(i + z[lane]) * W + lane] == T[static_cast<size_t>(z[lane]) * W + lane]);
+        z[lane] += eq;
+        active[lane] = eq;
+        any |= eq;
+      }
+    }
+
+    // Move the Z-box forward and store the Z-values
+    for (int lane{0}; lane < W; ++lane) {
+      int grow = i + z[lane] > r[lane];
+      l[lane] = grow ? i : l[lane];
+      r[lane] = grow ? i + z[lane] : r[lane];
+      Z[static_cast<size_t>(i) * W + lane] = z[lane];
+    }
+  }
+
+  // Scatter the lanes back into the contiguous arena
+  for (int lane{0}; lane < count; ++lane) {
+    int* dest = out.zarena.data() + out.offsets[ids[lane]];
+    for (int p{0}; p < len[lane]; ++p)
+      dest[p] = Z[static_cast<size_t>(p) * W + lane];
+
+    if (!out.barena.empty())
+      zarray_to_border(dest, out.barena.data() + out.offsets[ids[lane]], len[lane]);
+  }
+}
+
+}
+
+size_t ZBatch::size() const {
+  return offsets.empty() ? 0 : offsets.size() - 1;
+}
+
+const int* ZBatch::zarray(size_t k) const {
+  return zarena.data() + offsets.at(k);
+}
+
+const int* ZBatch::border(size_t k) const {
+  return barena.empty() ? nullptr : barena.data() + offsets.at(k);
+}
+
+/**
+ * Converts a Z-array into the border array (prefix function) of the same string.
+ * B[i] is the length of the longest proper border of S[0..i].
+ *
+ * @param Z An int* that points to a length |S| Z-array
+ * @param B An int* that points to a length |S| int[] which receives the borders
+ * @param length The length of the string
+ */
+void zarray_to_border(const int* Z, int* B, int length) {
+  std::fill(B, B + length, 0);
+
+  // Each Z-box ending at i + Z[i] - 1 is a border of that prefix
+  for (int i{1}; i < length; ++i) {
+    if (Z[i] > 0)
+      B[i + Z[i] - 1] = std::max(B[i + Z[i] - 1], Z[i]);
+  }
+
+  // Shorter prefixes inherit a border one shorter than their right neighbor
+  for (int i{length - 2}; i >= 0; --i)
+    B[i] = std::max(B[i], B[i + 1] - 1);
+}
+
+/**
+ * Returns the Z-arrays of every string in S, computed ZBATCH_LANES strings at a time
+ * and spread across threads. Z[0] is stored as 0, matching create_zarray.
+ *
+ * @param S A std::vector<std::string> holding the batch of strings
+ * @param borders Whether to also fill the border (prefix function) arena
+ * @param threads The number of worker threads (0 uses every hardware thread)
+ *
+ * @return A ZBatch holding all Z-arrays in one contiguous arena
+ */
+ZBatch create_zarray_batch(const std::vector<std::string>& S, bool borders, unsigned threads) {
+  ZBatch out;
+
+  // Lay out the arena
+  out.offsets.resize(S.size() + 1, 0);
+  for (size_t k{0}; k < S.size(); ++k)
+    out.offsets[k + 1] = out.offsets[k] + static_cast<long>(S[k].length());
+
+  out.zarena.resize(out.offsets.back());
+  if (borders)
+    out.barena.resize(out.offsets.back());
+
+  // Group strings of similar length so lanes finish together
+  std::vector<size_t> order(S.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&S](size_t a, size_t b) {
+    return S[a].length() < S[b].length();
+  });
+
+  size_t blocks = (S.size() + ZBATCH_LANES - 1) / ZBATCH_LANES;
+  if (threads == 0)
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  threads = static_cast<unsigned>(std::min<size_t>(threads, blocks));
+
+  // Each worker owns a contiguous range of blocks; arena slices never overlap
+  auto work = [&](size_t firstBlock, size_t lastBlock) {
+    for (size_t b{firstBlock}; b < lastBlock; ++b) {
+      size_t first = b * ZBATCH_LANES;
+      int count = static_cast<int>(std::min<size_t>(ZBATCH_LANES, S.size() - first));
+      zarray_block(S, order.data() + first, count, out);
+    }
+  };
+
+  if (threads <= 1) {
+    work(0, blocks);
+    return out;
+  }
+
+  std::vector<std::thread> pool;
+  for (unsigned t{0}; t < threads; ++t)
+    pool.emplace_back(work, blocks * t / threads, blocks * (t + 1) / threads);
+  for (auto& th : pool)
+    th.join();
+
+  return out;
+}
@@ -0,0 +1,37 @@
+/**
+ * @file zbatch.h
+ * Declarations of batched Z-array computation over many short strings.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Number of strings processed side by side in one transposed block
+const int ZBATCH_LANES = 16;
+
+/**
+ * The Z-arrays (and optionally border arrays) of a batch of strings,
+ * stored back to back in one contiguous arena.
+ *
+ * The values for string k live in [offsets[k], offsets[k + 1]) of each arena.
+ */
+struct ZBatch
+{
+  std::vector<long> offsets;
+  std::vector<int> zarena;
+  std::vector<int> barena;
+
+  // Returns the number of strings in the batch
+  size_t size() const;
+
+  // Returns a pointer to the Z-array of string k
+  const int* zarray(size_t k) const;
+
+  // Returns a pointer to the border array of string k (nullptr if not computed)
+  const int* border(size_t k) const;
+};
+
+ZBatch create_zarray_batch(const std::vector<std::string>& S, bool borders = false, unsigned threads = 0);
+void zarray_to_border(const int* Z, int* B, int length);
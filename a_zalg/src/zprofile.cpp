@@ -0,0 +1,74 @@
+/**
+ * @file zprofile.cpp
+ * Code to run the Z-algorithm and Boyer-Moore under a comparison profiler.
+ *
+ * The Z-algorithm compares characters through cs225::zstring on S = P + '$' + T, so its
+ * profiler is built with offset |P| + 1; Boyer-Moore compares in T directly (offset 0).
+ * Either way the profiled positions are positions in T.
+ */
+
+#include <iostream>
+#include <vector>
+
+#include "zprofile.h"
+#include "zalg.h"
+#include "bmoore.h"
+
+/**
+ * Returns the index positions of all exact matches of P in T using the Z-algorithm,
+ * recording every comparison and Z-box hit in profiler.
+ * If no match is found, returns a vector with one value '[-1]'
+ *
+ * @param P A std::string object which holds the Pattern string.
+ * @param T A std::string object which holds the Text string.
+ * @param profiler A cs225::Profiler over |T| positions with offset |P| + 1
+ *
+ * @return An std::vector<int> array containing ALL index matches.
+ */
+std::vector<int> zalg_profile(std::string P, std::string T, cs225::Profiler& profiler) {
+  std::vector<int> outList;
+
+  std::string S = P + '$' + T;
+  std::vector<int> zarr(S.length());
+
+  create_zarray(S, zarr.data(), &profiler);
+
+  for (unsigned long i{P.length() + 1}; i < S.length(); i++) {
+    if (static_cast<unsigned long>(zarr[i]) == P.length())
+      outList.push_back(i - P.length() - 1);
+  }
+
+  if (outList.empty())
+    outList.push_back(-1);
+
+  return outList;
+}
+
+/**
+ * Returns the index positions of all exact matches of P in T by running a_bmoore's
+ * bmoore_search (strong bad character rule, right-to-left scanning) with profiler
+ * attached, so the heatmap shows the comparisons and shifts of that engine.
+ * If no match is found, returns a vector with one value '[-1]'
+ *
+ * @param P A std::string object which holds the Pattern string.
+ * @param T A std::string object which holds the Text string.
+ * @param profiler A cs225::Profiler over |T| positions with offset 0
+ *
+ * @return An std::vector<int> array containing ALL index matches.
+ */
+std::vector<int> bmoore_profile(std::string P, std::string T, cs225::Profiler& profiler) {
+  // bmoore_search needs every character of P and T in its alphabet
+  bool seen[256] = {false};
+  for (unsigned char c : P + T)
+    seen[c] = true;
+  std::string alpha;
+  for (int c{0}; c < 256; c++) {
+    if (seen[c])
+      alpha += static_cast<char>(c);
+  }
+
+  std::vector<int> outList;
+  bmoore_search(P, T, alpha, outList, &profiler);
+
+  return outList;
+}
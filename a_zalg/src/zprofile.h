@@ -0,0 +1,13 @@
+/**
+ * @file zprofile.h
+ * Declarations of profiled matcher runs that feed a cs225::Profiler.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include "cs225/profiler.h"
+
+std::vector<int> zalg_profile(std::string P, std::string T, cs225::Profiler& profiler);
+std::vector<int> bmoore_profile(std::string P, std::string T, cs225::Profiler& profiler);
\ No newline at end of file
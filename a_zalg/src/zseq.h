@@ -0,0 +1,155 @@
+/**
+ * @file zseq.h
+ * Templated Z-algorithm and prefix function over arbitrary token sequences.
+ *
+ * These work on any random-access sequence of equality-comparable items
+ * (a std::string, a std::vector<uint32_t> of token ids, a pair of pointers...)
+ * and store positions in a templated Index type, so sequences longer than
+ * 2^31 items are supported by the default 64-bit index.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+/**
+ * Returns the Z-array of the sequence [first, last).
+ * As with create_zarray, Z[0] is stored as 0.
+ *
+ * @param first A random-access iterator to the first item
+ * @param last A random-access iterator past the last item
+ *
+ * @return An std::vector<Index> storing the Z-value at each position
+ */
+template <typename Index = std::int64_t, typename It>
+std::vector<Index> create_zarray_seq(It first, It last) {
+  Index n = static_cast<Index>(last - first);
+  std::vector<Index> Z(n, 0);
+
+  // Z-box [l, r)
+  Index l = 0;
+  Index r = 0;
+  for (Index i{1}; i < n; ++i) {
+    Index z = 0;
+
+    // Case #2: i inside the Z-box, reuse Z[k]
+    if (i < r) {
+      Index k = i - l;
+      Index B = r - i;
+      if (Z[k] != B) {
+        Z[i] = std::min(Z[k], B);
+        continue;
+      }
+      z = B;
+    }
+
+    // Case #1 / #2b: compare explicitly past the Z-box
+    while (i + z < n && first[i + z] == first[z])
+      z++;
+
+    Z[i] = z;
+    if (i + z > r) {
+      l = i;
+      r = i + z;
+    }
+  }
+
+  return Z;
+}
+
+/**
+ * Returns the prefix function (border array) of the sequence [first, last).
+ * B[i] is the length of the longest proper border of the first i + 1 items.
+ *
+ * @param first A random-access iterator to the first item
+ * @param last A random-access iterator past the last item
+ *
+ * @return An std::vector<Index> storing the border length at each position
+ */
+template <typename Index = std::int64_t, typename It>
+std::vector<Index> create_border_seq(It first, It last) {
+  Index n = static_cast<Index>(last - first);
+  std::vector<Index> B(n, 0);
+
+  for (Index i{1}; i < n; ++i) {
+    // Fall back through shorter borders until one can be extended
+    Index b = B[i - 1];
+    while (b > 0 && !(first[i] == first[b]))
+      b = B[b - 1];
+    if (first[i] == first[b])
+      b++;
+    B[i] = b;
+  }
+
+  return B;
+}
+
+/**
+ * Returns the index positions of all exact matches of P in T.
+ * Uses the Z-array of P only, so no separator item is ever needed.
+ * If no match is found, returns an empty vector.
+ *
+ * @param pFirst, pLast The pattern sequence
+ * @param tFirst, tLast The text sequence
+ *
+ * @return An std::vector<Index> containing ALL index matches.
+ */
+template <typename Index = std::int64_t, typename PIt, typename TIt>
+std::vector<Index> zalg_search_seq(PIt pFirst, PIt pLast, TIt tFirst, TIt tLast) {
+  std::vector<Index> outList;
+
+  Index m = static_cast<Index>(pLast - pFirst);
+  Index n = static_cast<Index>(tLast - tFirst);
+  if (m == 0 || m > n)
+    return outList;
+
+  std::vector<Index> Z = create_zarray_seq<Index>(pFirst, pLast);
+
+  // Z-box [l, r) over T: T[l, r) matches P[0, r - l)
+  Index l = 0;
+  Index r = 0;
+  for (Index i{0}; i + m <= n; ++i) {
+    Index z = 0;
+
+    if (i < r) {
+      Index k = i - l;
+      Index B = r - i;
+      // P[k..] disagrees with P inside the box, so no match can start here
+      if (Z[k] != B)
+        continue;
+      z = B;
+    }
+
+    while (z < m && tFirst[i + z] == pFirst[z])
+      z++;
+
+    if (i + z > r) {
+      l = i;
+      r = i + z;
+    }
+    if (z == m)
+      outList.push_back(i);
+  }
+
+  return outList;
+}
+
+// Range overloads for any container with std::begin / std::end
+
+template <typename Index = std::int64_t, typename Seq>
+std::vector<Index> create_zarray_seq(const Seq& S) {
+  return create_zarray_seq<Index>(std::begin(S), std::end(S));
+}
+
+template <typename Index = std::int64_t, typename Seq>
+std::vector<Index> create_border_seq(const Seq& S) {
+  return create_border_seq<Index>(std::begin(S), std::end(S));
+}
+
+template <typename Index = std::int64_t, typename PSeq, typename TSeq>
+std::vector<Index> zalg_search_seq(const PSeq& P, const TSeq& T) {
+  return zalg_search_seq<Index>(std::begin(P), std::end(P), std::begin(T), std::end(T));
+}
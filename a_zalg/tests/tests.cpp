@@ -3,8 +3,13 @@
 #include <string>
 #include <iostream>
 #include <vector>
+#include <cstdio>
 
 #include "zalg.h"
+#include "zbatch.h"
+#include "zseq.h"
+#include "zprofile.h"
+#include "lodepng/lodepng.h"
 
 /*
 * Helper functions for basic tests
@@ -156,4 +161,158 @@ TEST_CASE("Z-array computed semi-efficiently", "[weight=10]") {
 
   check_Zarray_efficiency(P,T,ans_comps,delta);
 
-}
\ No newline at end of file
+}
+
+/*
+* Batch Z-array test cases
+*/
+
+void testZbatch(std::vector<std::string> S, unsigned threads){
+  ZBatch batch = create_zarray_batch(S, true, threads);
+
+  REQUIRE(batch.size() == S.size());
+
+  for(size_t k = 0; k < S.size(); ++k){
+    int len = S[k].length();
+    std::vector<int> zarr(len + 1, 0);
+    if(len > 0){
+      create_zarray(S[k], zarr.data());
+    }
+
+    for(int i = 1; i < len; ++i){
+      if(batch.zarray(k)[i] != zarr[i]){
+        INFO("String " + std::to_string(k) + " at index value " + std::to_string(i) + " had an incorrect batched Z-value.");
+        REQUIRE(batch.zarray(k)[i] == zarr[i]);
+      }
+    }
+
+    // Border of S[0..i] checked against the definition
+    for(int i = 0; i < len; ++i){
+      int b = i;
+      while(b > 0 && S[k].compare(0, b, S[k], i + 1 - b, b) != 0){
+        b--;
+      }
+      if(batch.border(k)[i] != b){
+        INFO("String " + std::to_string(k) + " at index value " + std::to_string(i) + " had an incorrect border.");
+        REQUIRE(batch.border(k)[i] == b);
+      }
+    }
+  }
+}
+
+TEST_CASE("Batched Z-values match create_zarray", "[weight=0]") {
+  std::vector<std::string> S = {"AAA$BAAAT", "aaaaaaaaaa", "", "a", "CGACGA$CGCGCGCG",
+    "pattern$this is a pattern that has a repeat pattern", "abababab", "abcabcabd"};
+
+  testZbatch(S, 1);
+}
+
+TEST_CASE("Batched Z-values are correct across threads and lanes", "[weight=0]") {
+  std::vector<std::string> S;
+  unsigned seed = 225;
+  for(int k = 0; k < 100; ++k){
+    std::string s;
+    int len = 20 + k % 37;
+    for(int i = 0; i < len; ++i){
+      seed = seed * 1103515245 + 12345;
+      s += "ACGT"[(seed >> 16) % (k % 2 ? 2 : 4)];
+    }
+    S.push_back(s);
+  }
+
+  testZbatch(S, 1);
+  testZbatch(S, 4);
+}
+
+/*
+* Token sequence Z-algorithm test cases
+*/
+
+TEST_CASE("Templated Z-values match create_zarray", "[weight=0]") {
+  std::string S = "matters$It matters that the third matters mattErs. It also may matteRs that this sentence also matters";
+  int *zarr = new int[S.length()];
+
+  create_zarray(S, zarr);
+  std::vector<long long> zseq = create_zarray_seq<long long>(S);
+
+  REQUIRE(zseq.size() == S.length());
+  for(size_t i = 1; i < S.length(); ++i){
+    REQUIRE(zseq[i] == zarr[i]);
+  }
+
+  delete[] zarr;
+}
+
+TEST_CASE("Templated Z-algorithm works on token ids", "[weight=0]") {
+  std::vector<uint32_t> P = {7, 3, 7};
+  std::vector<uint32_t> T = {7, 3, 7, 3, 7, 1, 7, 3, 7, 7, 3};
+
+  std::vector<uint64_t> Z = create_zarray_seq<uint64_t>(T);
+  std::vector<uint64_t> ansZ = {0, 0, 3, 0, 1, 0, 3, 0, 1, 2, 0};
+  REQUIRE(Z == ansZ);
+
+  std::vector<uint64_t> B = create_border_seq<uint64_t>(T);
+  std::vector<uint64_t> ansB = {0, 0, 1, 2, 3, 0, 1, 2, 3, 1, 2};
+  REQUIRE(B == ansB);
+
+  std::vector<int64_t> out = zalg_search_seq(P, T);
+  std::vector<int64_t> ans = {0, 2, 6};
+  REQUIRE(out == ans);
+
+  REQUIRE(zalg_search_seq(std::vector<uint32_t>{4}, T).empty());
+}
+
+TEST_CASE("Templated search matches zalg_search on strings", "[weight=0]") {
+  std::string P = "aaa";
+  std::string T = "aaaabaaaaaab";
+
+  std::vector<int> ans = zalg_search(P, T);
+  std::vector<int> out = zalg_search_seq<int>(P, T);
+
+  REQUIRE(out == ans);
+}
+
+/*
+* Comparison profiler test cases
+*/
+
+TEST_CASE("Profiler accounts for every text comparison", "[weight=0]") {
+  std::string P = "matters";
+  std::string T = "It matters that the third matters mattErs. It also may matteRs that this sentence also matters";
+
+  cs225::Profiler zprof(T.length(), P.length() + 1, 4);
+  std::vector<int> out = zalg_profile(P, T, zprof);
+  REQUIRE(out == zalg_search(P, T));
+  REQUIRE(zprof.blocks() == static_cast<long>((T.length() + 3) / 4));
+
+  // Every Z comparison in T compares one text character
+  std::string S = P + "$" + T;
+  int *zarr = new int[S.length()];
+  cs225::Profiler full(S.length());
+  int charComps = create_zarray(S, zarr, &full);
+  REQUIRE(full.getTotalComparisons() == charComps);
+  delete[] zarr;
+
+  // Boyer-Moore is a_bmoore's engine, comparing in T directly
+  cs225::Profiler bprof(T.length());
+  REQUIRE(bmoore_profile(P, T, bprof) == out);
+  REQUIRE(bprof.getTotalComparisons() > 0);
+  REQUIRE(bprof.getTotalComparisons() < zprof.getTotalComparisons());
+}
+
+TEST_CASE("Profiler renders a heatmap PNG", "[weight=0]") {
+  std::string P = "aaa";
+  std::string T(5000, 'a');
+
+  cs225::Profiler prof(T.length(), P.length() + 1);
+  zalg_profile(P, T, prof);
+  REQUIRE(prof.writePNG("profile_test.png", 800));
+
+  std::vector<unsigned char> image;
+  unsigned w, h;
+  REQUIRE(lodepng::decode(image, w, h, "profile_test.png") == 0);
+  REQUIRE(w == prof.blocks());
+  REQUIRE(h > 0);
+
+  std::remove("profile_test.png");
+}
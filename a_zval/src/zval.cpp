@@ -99,13 +99,13 @@ std::vector<int> zval_search(std::string P, std::string T) {
     }
   }
 
+  delete[] zarr; // No memory leaks here!
+
   // The vector can check if it is currently empty
   if (outList.empty()) {
     outList.push_back(-1);
     return outList;
   }
 
-  delete[] zarr; // No memory leaks here!
-
   return outList;
 }
\ No newline at end of file